@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "corpus.hpp"
+#include "psql_parse/batch.hpp"
+#include "psql_parse/cache.hpp"
+#include "psql_parse/deparse.hpp"
+#include "psql_parse/driver.hpp"
+#include "psql_parse/fingerprint.hpp"
+#include "psql_parse/flat.hpp"
+#include "psql_parse/scanner.hpp"
+#include "psql_parse/session.hpp"
+#include "psql_parse/tokens.hpp"
+#include "psql_parse/visit.hpp"
+
+/*
+ * Counts every call to the global allocation functions, so the numbers
+ * include the scanner and parser as well as the AST itself.
+ */
+namespace {
+    std::atomic<std::size_t> allocations = 0;
+    std::atomic<std::size_t> allocated_bytes = 0;
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+    using bench::Workload;
+    using Clock = std::chrono::steady_clock;
+
+    // minimum run time of every case, set from the command line
+    std::chrono::milliseconds budget { 300 };
+
+    struct Result {
+        double statements_per_second;
+        double tokens_per_second;
+        double megabytes_per_second;
+        double allocations_per_statement;
+        double bytes_per_statement;
+        double peak_rss_megabytes;
+    };
+
+    /* Start a new peak, so that every case reports its own (Linux only) */
+    void resetPeakRss() {
+#ifdef __linux__
+        if (std::FILE* clear_refs = std::fopen("/proc/self/clear_refs", "w")) {
+            std::fputs("5", clear_refs);
+            std::fclose(clear_refs);
+        }
+#endif
+    }
+
+    double peakRssMegabytes() {
+#ifdef __linux__
+        if (std::FILE* status = std::fopen("/proc/self/status", "r")) {
+            char line[256];
+            long kilobytes = -1;
+            while (std::fgets(line, sizeof line, status)) {
+                if (std::sscanf(line, "VmHWM: %ld kB", &kilobytes) == 1) {
+                    break;
+                }
+            }
+            std::fclose(status);
+            if (kilobytes >= 0) {
+                return static_cast<double>(kilobytes) / 1024;
+            }
+        }
+#endif
+        // the process wide peak; kilobytes on Linux, bytes on macOS
+        rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_maxrss) / 1024;
+    }
+
+    void mustParse(bool ok, std::string_view sql) {
+        if (!ok) {
+            std::fprintf(stderr, "failed to parse: %.*s\n", static_cast<int>(sql.size()), sql.data());
+            std::exit(1);
+        }
+    }
+
+    std::size_t scan(psql_parse::scanner& scanner, const Workload& workload) {
+        std::size_t tokens = 0;
+        for (auto const& sql : workload.statements) {
+            scanner.reset(std::string_view(sql));
+            while (scanner.lex().kind() != psql_parse::parser::symbol_kind::S_YYEOF) {
+                tokens++;
+            }
+        }
+        return tokens;
+    }
+
+    /*
+     * Call pass(), which handles the whole workload once, until the
+     * budget is used up. Throughput is reported in terms of the source
+     * text, whatever the pass does with it.
+     */
+    template <class Pass>
+    Result measure(const Workload& workload, std::size_t tokens, Pass&& pass) {
+        pass();
+        resetPeakRss();
+
+        std::size_t passes = 0;
+        std::size_t before = allocations;
+        std::size_t before_bytes = allocated_bytes;
+        auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+
+        do {
+            pass();
+            passes++;
+            elapsed = Clock::now() - start;
+        } while (elapsed < budget);
+
+        auto seconds = std::chrono::duration<double>(elapsed).count();
+        auto statements = static_cast<double>(passes * workload.statements.size());
+        return Result {
+            statements / seconds,
+            static_cast<double>(passes * tokens) / seconds,
+            static_cast<double>(passes * workload.bytes()) / seconds / 1e6,
+            static_cast<double>(allocations - before) / statements,
+            static_cast<double>(allocated_bytes - before_bytes) / statements,
+            peakRssMegabytes()
+        };
+    }
+
+    Result runScan(const Workload& workload, std::size_t tokens) {
+        psql_parse::scanner scanner;
+        return measure(workload, tokens, [&] { scan(scanner, workload); });
+    }
+
+    // tokenize() into a reused vector, no values and no parser
+    Result runTokenize(const Workload& workload, std::size_t tokens) {
+        std::vector<psql_parse::Token> stream;
+        return measure(workload, tokens, [&] {
+            for (auto const& sql : workload.statements) {
+                stream.clear();
+                psql_parse::tokenize(sql, stream);
+            }
+        });
+    }
+
+    Result runParse(const Workload& workload, std::size_t tokens, bool arena) {
+        psql_parse::driver driver;
+        driver.useArena(arena);
+        return measure(workload, tokens, [&] {
+            for (auto const& sql : workload.statements) {
+                mustParse(driver.parse(std::string_view(sql)), sql);
+            }
+        });
+    }
+
+    // what callers holding a string had to do before parse(string_view)
+    Result runIstream(const Workload& workload, std::size_t tokens, bool arena) {
+        psql_parse::driver driver;
+        driver.useArena(arena);
+        return measure(workload, tokens, [&] {
+            for (auto const& sql : workload.statements) {
+                std::istringstream in(sql);
+                mustParse(driver.parse(in), sql);
+            }
+        });
+    }
+
+    // the whole workload as one ';'-separated script
+    Result runScript(const Workload& workload, std::size_t tokens, bool arena) {
+        std::string script;
+        for (auto const& sql : workload.statements) {
+            script.append(sql).append(";\n");
+        }
+
+        psql_parse::driver driver;
+        driver.useArena(arena);
+        return measure(workload, tokens, [&] {
+            mustParse(driver.parseScript(script, [](psql_parse::Statement&) {}), script);
+        });
+    }
+
+    // one statement after another through a ParseSession
+    Result runSession(const Workload& workload, std::size_t tokens) {
+        psql_parse::ParseSession session;
+        return measure(workload, tokens, [&] {
+            for (auto const& sql : workload.statements) {
+                mustParse(session.parse(sql) != nullptr, sql);
+            }
+        });
+    }
+
+    // get() on a warm ParseCache, every lookup a hit
+    Result runCache(const Workload& workload, std::size_t tokens) {
+        psql_parse::ParseCache cache(1024);
+        return measure(workload, tokens, [&] {
+            for (auto const& sql : workload.statements) {
+                mustParse(cache.get(sql) != nullptr, sql);
+            }
+        });
+    }
+
+    std::vector<psql_parse::Statement> parseAll(const Workload& workload) {
+        psql_parse::driver driver;
+        std::vector<psql_parse::Statement> statements;
+        for (auto const& sql : workload.statements) {
+            mustParse(driver.parse(std::string_view(sql)), sql);
+            statements.push_back(std::move(driver.getResult()));
+        }
+        return statements;
+    }
+
+    // fingerprint() over already parsed statements
+    Result runFingerprint(const Workload& workload, std::size_t tokens) {
+        auto statements = parseAll(workload);
+
+        std::uint64_t sink = 0;
+        auto result = measure(workload, tokens, [&] {
+            for (auto& stmt : statements) {
+                sink ^= psql_parse::fingerprint(stmt);
+            }
+        });
+        if (sink == 42) {
+            std::printf("\n");
+        }
+        return result;
+    }
+
+    // FlatTree::assign() over already parsed statements, into a reused tree
+    Result runFlatten(const Workload& workload, std::size_t tokens) {
+        auto statements = parseAll(workload);
+        psql_parse::FlatTree flat;
+        return measure(workload, tokens, [&] {
+            for (auto& stmt : statements) {
+                flat.assign(stmt);
+            }
+        });
+    }
+
+    /*
+     * deparse() of already parsed statements into one reused buffer.
+     * MB/s is of the SQL written rather than of the source text.
+     */
+    Result runDeparse(const Workload& workload, std::size_t tokens) {
+        auto statements = parseAll(workload);
+        std::string out;
+        std::size_t written = 0;
+        auto result = measure(workload, tokens, [&] {
+            written = 0;
+            for (auto& stmt : statements) {
+                out.clear();
+                psql_parse::deparse(stmt, out);
+                written += out.size();
+            }
+        });
+        result.megabytes_per_second *= static_cast<double>(written) / static_cast<double>(workload.bytes());
+        return result;
+    }
+
+    struct VarCounter {
+        std::size_t vars = 0;
+
+        void enter(psql_parse::box<psql_parse::Var>&) { vars++; }
+        void enter(const psql_parse::Flat<psql_parse::Var>&) { vars++; }
+    };
+
+    // a pre-order walk that counts column references, over the trees or their flat forms
+    Result runWalk(const Workload& workload, std::size_t tokens, bool flat) {
+        auto statements = parseAll(workload);
+        std::vector<psql_parse::FlatTree> flats(statements.begin(), statements.end());
+
+        VarCounter counter;
+        psql_parse::default_visit<VarCounter> walker { counter };
+        auto result = measure(workload, tokens, [&] {
+            if (flat) {
+                for (auto& tree : flats) {
+                    tree.walk(counter);
+                }
+            } else {
+                for (auto& stmt : statements) {
+                    walker.visit(stmt);
+                }
+            }
+        });
+        if (counter.vars == 42) {
+            std::printf("\n");
+        }
+        return result;
+    }
+
+    /*
+     * Load the workload from one buffer of FlatTree blobs, as if read
+     * from a mapped file: read() validates each blob in place, then it is
+     * either walked where it lies or expanded into an arena.
+     */
+    Result runLoad(const Workload& workload, std::size_t tokens, bool expand) {
+        std::string blobs;
+        for (auto& stmt : parseAll(workload)) {
+            psql_parse::FlatTree(stmt).write(blobs);
+        }
+
+        VarCounter counter;
+        psql_parse::Arena arena;
+        auto result = measure(workload, tokens, [&] {
+            std::string_view bytes = blobs;
+            std::size_t loaded = 0;
+            while (auto view = psql_parse::FlatView::read(bytes)) {
+                if (expand) {
+                    psql_parse::Statement stmt = view->expand(&arena);
+                } else {
+                    view->walk(counter);
+                }
+                loaded++;
+            }
+            mustParse(loaded == workload.statements.size(), "blobs");
+            arena.reset();
+        });
+        if (counter.vars == 42) {
+            std::printf("\n");
+        }
+        return result;
+    }
+
+    // stmts/s of parseBatch over copies of the workload
+    double runBatch(const Workload& workload, unsigned threads) {
+        std::vector<std::string_view> queries;
+        while (queries.size() < 2000) {
+            for (auto const& sql : workload.statements) {
+                queries.emplace_back(sql);
+            }
+        }
+
+        std::size_t statements = 0;
+        auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        do {
+            for (auto const& result : psql_parse::parseBatch(queries, threads)) {
+                if (!result.has_value()) {
+                    std::fprintf(stderr, "failed to parse batch\n");
+                    std::exit(1);
+                }
+            }
+            statements += queries.size();
+            elapsed = Clock::now() - start;
+        } while (elapsed < budget);
+
+        return static_cast<double>(statements) / std::chrono::duration<double>(elapsed).count();
+    }
+
+    void header(const char* first, const char* second) {
+        std::printf("%-14s %-18s %12s %12s %9s %12s %12s %9s\n", first, second, "stmts/s", "tokens/s",
+                    "MB/s", "allocs/stmt", "bytes/stmt", "peak MB");
+    }
+
+    void print(const std::string& first, const char* second, const Result& r) {
+        std::printf("%-14s %-18s %12.0f %12.0f %9.2f %12.1f %12.1f %9.1f\n", first.c_str(), second,
+                    r.statements_per_second, r.tokens_per_second, r.megabytes_per_second,
+                    r.allocations_per_statement, r.bytes_per_statement, r.peak_rss_megabytes);
+    }
+}
+
+/*
+ * psql_bench [milliseconds per case]
+ *
+ * Every case repeats its workload for at least the given time
+ * (300 ms by default).
+ */
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        budget = std::chrono::milliseconds(std::max(1, std::atoi(argv[1])));
+    }
+
+    auto corpus = bench::corpus();
+    psql_parse::scanner scanner;
+
+    header("workload", "stage");
+    for (auto const& workload : corpus) {
+        auto tokens = scan(scanner, workload);
+        print(workload.name, "tokenize", runTokenize(workload, tokens));
+        print(workload.name, "scan", runScan(workload, tokens));
+        print(workload.name, "scan+parse", runParse(workload, tokens, false));
+    }
+
+    std::printf("\n");
+    header("workload", "output");
+    for (auto const& workload : corpus) {
+        print(workload.name, "deparse", runDeparse(workload, scan(scanner, workload)));
+    }
+
+    // everyday statements, for comparing the ways of calling the parser
+    Workload mixed { "oltp+analytics", corpus[0].statements };
+    mixed.statements.insert(mixed.statements.end(), corpus[1].statements.begin(), corpus[1].statements.end());
+    auto tokens = scan(scanner, mixed);
+
+    std::printf("\n");
+    header("workload", "input/nodes");
+    print(mixed.name, "istream/heap", runIstream(mixed, tokens, false));
+    print(mixed.name, "istream/arena", runIstream(mixed, tokens, true));
+    print(mixed.name, "string_view/heap", runParse(mixed, tokens, false));
+    print(mixed.name, "string_view/arena", runParse(mixed, tokens, true));
+    print(mixed.name, "script/heap", runScript(mixed, tokens, false));
+    print(mixed.name, "script/arena", runScript(mixed, tokens, true));
+    print(mixed.name, "session", runSession(mixed, tokens));
+    print(mixed.name, "cache hit", runCache(mixed, tokens));
+    print(mixed.name, "fingerprint", runFingerprint(mixed, tokens));
+    print(mixed.name, "flatten", runFlatten(mixed, tokens));
+    print(mixed.name, "walk tree", runWalk(mixed, tokens, false));
+    print(mixed.name, "walk flat", runWalk(mixed, tokens, true));
+    print(mixed.name, "load blob+walk", runLoad(mixed, tokens, false));
+    print(mixed.name, "load blob+expand", runLoad(mixed, tokens, true));
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("\n%-20s %12s %10s\n", "parseBatch threads", "stmts/s", "speedup");
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < cores; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(cores);
+
+    double single = 0;
+    for (unsigned threads : thread_counts) {
+        double rate = runBatch(mixed, threads);
+        if (threads == 1) {
+            single = rate;
+        }
+        std::printf("%-20u %12.0f %10.2f\n", threads, rate, rate / single);
+    }
+}
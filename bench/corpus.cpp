@@ -0,0 +1,199 @@
+#include <string>
+
+#include "corpus.hpp"
+
+namespace bench {
+
+    std::size_t Workload::bytes() const {
+        std::size_t total = 0;
+        for (auto const& sql : statements) {
+            total += sql.size();
+        }
+        return total;
+    }
+
+    namespace {
+        Workload oltp() {
+            return Workload { "oltp", {
+                "select cname, cbalance, ccredit from customer where ccustkey = 4711",
+                "select * from orders where oorderkey = 123456",
+                "select sprice, squantity from stock where siid = 77 and swid = 1",
+                "select count(*) from orderline where olwid = 1 and oldid = 5 and oloid < 3001",
+                "select distinct ctype from customer where cname like 'Smith%'",
+                "insert into orders (oid, odid, owid, ocid, oentryd, ocarrierid, olcnt, oalllocal) "
+                "values (3001, 5, 1, 1234, '2024-01-01 10:00:00', 7, 12, true)",
+                "insert into history values (1234, 5, 1, 5, 1, 10.5, 'payment')",
+                "delete from neworder where nooid = 2101 and nodid = 5 and nowid = 1",
+                "delete from sessions where expires < 1700000000",
+            }};
+        }
+
+        Workload analytics() {
+            return Workload { "analytics", {
+                // TPC-H Q1
+                "select lreturnflag, llinestatus, sum(lquantity) as sumqty, sum(lextendedprice) as sumbaseprice, "
+                "sum(lextendedprice * (1 - ldiscount)) as sumdiscprice, "
+                "sum(lextendedprice * (1 - ldiscount) * (1 + ltax)) as sumcharge, avg(lquantity) as avgqty, "
+                "avg(lextendedprice) as avgprice, avg(ldiscount) as avgdisc, count(*) as countorder "
+                "from lineitem where lshipdate <= '1998-09-02' "
+                "group by lreturnflag, llinestatus order by lreturnflag, llinestatus",
+
+                // TPC-H Q3
+                "select lorderkey, sum(lextendedprice * (1 - ldiscount)) as revenue, oorderdate, oshippriority "
+                "from customer, orders, lineitem "
+                "where cmktsegment = 'BUILDING' and ccustkey = ocustkey and lorderkey = oorderkey "
+                "and oorderdate < '1995-03-15' and lshipdate > '1995-03-15' "
+                "group by lorderkey, oorderdate, oshippriority "
+                "order by revenue desc, oorderdate fetch first 10 rows only",
+
+                // TPC-H Q5, with explicit joins
+                "select nname, sum(lextendedprice * (1 - ldiscount)) as revenue "
+                "from customer join orders on ccustkey = ocustkey join lineitem on lorderkey = oorderkey "
+                "join supplier on lsuppkey = ssuppkey join nation on snationkey = nnationkey "
+                "join region on nregionkey = rregionkey "
+                "where rname = 'ASIA' and oorderdate >= '1994-01-01' and oorderdate < '1995-01-01' "
+                "group by nname order by revenue desc",
+
+                // TPC-H Q6
+                "select sum(lextendedprice * ldiscount) as revenue from lineitem "
+                "where lshipdate >= '1994-01-01' and lshipdate < '1995-01-01' "
+                "and ldiscount between 0.05 and 0.07 and lquantity < 24",
+
+                // TPC-H Q15
+                "with revenue (supplierno, totalrevenue) as ("
+                "select lsuppkey, sum(lextendedprice * (1 - ldiscount)) from lineitem "
+                "where lshipdate >= '1996-01-01' and lshipdate < '1996-04-01' group by lsuppkey) "
+                "select ssuppkey, sname, saddress, sphone, totalrevenue from supplier, revenue "
+                "where ssuppkey = supplierno and totalrevenue = (select max(totalrevenue) from revenue) "
+                "order by ssuppkey",
+
+                // TPC-H Q18
+                "select cname, ccustkey, oorderkey, oorderdate, ototalprice, sum(lquantity) "
+                "from customer, orders, lineitem "
+                "where oorderkey in (select lorderkey from lineitem group by lorderkey having sum(lquantity) > 300) "
+                "and ccustkey = ocustkey and oorderkey = lorderkey "
+                "group by cname, ccustkey, oorderkey, oorderdate, ototalprice "
+                "order by ototalprice desc, oorderdate fetch first 100 rows only",
+
+                // TPC-H Q21, anti join part
+                "select sname, count(*) as numwait from supplier, lineitem, orders "
+                "where ssuppkey = lsuppkey and oorderkey = lorderkey and oorderstatus = 'F' "
+                "and lreceiptdate > lcommitdate "
+                "and not exists (select lorderkey from lineitem where lorderkey = oorderkey "
+                "and lsuppkey <> ssuppkey and lreceiptdate > lcommitdate) "
+                "group by sname order by numwait desc, sname fetch first 100 rows only",
+
+                // TPC-DS like rollup and set operations
+                "select iclass, icategory, sum(ssnetprofit) as profit from storesales, item "
+                "where ssitemsk = iitemsk group by rollup (icategory, iclass) "
+                "order by icategory, iclass",
+                "select ccustkey from customer except select ocustkey from orders "
+                "union select scustkey from storesales",
+            }};
+        }
+
+        Workload wideInsert() {
+            Workload workload { "wide_insert", {} };
+            for (int table = 0; table < 4; table++) {
+                std::string columns;
+                std::string values;
+                for (int i = 0; i < 256; i++) {
+                    if (i > 0) {
+                        columns += ", ";
+                        values += ", ";
+                    }
+                    columns += "col" + std::to_string(i);
+                    switch (i % 5) {
+                        case 0: values += std::to_string(i * 7919 + table); break;
+                        case 1: values += std::to_string(i) + ".25"; break;
+                        case 2: values += "'value " + std::to_string(i) + "'"; break;
+                        case 3: values += i % 2 == 0 ? "true" : "false"; break;
+                        default: values += "-" + std::to_string(i); break;
+                    }
+                }
+                workload.statements.push_back(
+                        "insert into wide" + std::to_string(table) + " (" + columns + ") values (" + values + ")");
+            }
+            return workload;
+        }
+
+        Workload nested() {
+            const char* ops[] = { " + ", " - ", " * ", " / " };
+
+            std::string arithmetic = "a";
+            for (int depth = 0; depth < 64; depth++) {
+                arithmetic = "(" + arithmetic + ops[depth % 4] + std::to_string(depth + 1) + ")";
+            }
+
+            std::string predicate = "x64 = 64";
+            for (int depth = 63; depth >= 0; depth--) {
+                predicate = "(x" + std::to_string(depth) + " = " + std::to_string(depth)
+                        + (depth % 2 == 0 ? " and " : " or ") + predicate + ")";
+            }
+
+            std::string derived = "select a from t";
+            for (int depth = 0; depth < 16; depth++) {
+                derived = "select a from (" + derived + ") as d" + std::to_string(depth);
+            }
+
+            std::string subquery = "select a from t16";
+            for (int depth = 15; depth >= 0; depth--) {
+                subquery = "select a from t" + std::to_string(depth) + " where a in (" + subquery + ")";
+            }
+
+            return Workload { "nested", {
+                "select " + arithmetic + " from t",
+                "select a from t where " + predicate,
+                derived,
+                subquery,
+            }};
+        }
+
+        Workload createTable() {
+            const char* types[] = {
+                "integer", "bigint", "smallint", "decimal(15, 2)", "numeric(10)", "real",
+                "double precision", "float(24)", "varchar 64", "character 10", "boolean", "date",
+                "timestamp(3) with time zone", "time without time zone", "blob"
+            };
+
+            Workload workload { "create_table", {} };
+            for (int table = 0; table < 4; table++) {
+                std::string sql = "create table facts" + std::to_string(table) + " (";
+                for (int i = 0; i < 120; i++) {
+                    sql += "c" + std::to_string(i) + " " + types[(i + table) % std::size(types)];
+                    if (i % 7 == 0) {
+                        sql += " default 0";
+                    }
+                    if (i % 3 == 0) {
+                        sql += " not null";
+                    }
+                    sql += ", ";
+                }
+                sql += "primary key (c0, c1), unique (c2), unique (c3, c4, c5))";
+                workload.statements.push_back(std::move(sql));
+            }
+            return workload;
+        }
+
+        Workload bulkStrings() {
+            std::string text;
+            while (text.size() < 4096) {
+                text += "Lorem ipsum dolor sit amet, it''s consectetur adipiscing elit. ";
+            }
+
+            Workload workload { "bulk_strings", {} };
+            for (int row = 0; row < 8; row++) {
+                workload.statements.push_back(
+                        "insert into documents (id, title, body)\n"
+                        "        values (" + std::to_string(row) + ",\n"
+                        "                'document " + std::to_string(row) + "',\n"
+                        "                '" + text + "')");
+            }
+            return workload;
+        }
+    }
+
+    std::vector<Workload> corpus() {
+        return { oltp(), analytics(), wideInsert(), nested(), createTable(), bulkStrings() };
+    }
+}
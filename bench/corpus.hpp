@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    /*
+     * A named set of statements that is measured as a unit. Every
+     * statement parses on its own; none of them ends in ';'.
+     */
+    struct Workload {
+        std::string name;
+        std::vector<std::string> statements;
+
+        [[nodiscard]] std::size_t bytes() const;
+    };
+
+    /*
+     * The bundled corpus, in the order it is reported:
+     *   oltp          short point queries, single row inserts and deletes
+     *   analytics     TPC-H like joins, aggregates, subqueries and CTEs
+     *   wide_insert   INSERT with hundreds of columns and values
+     *   nested        deeply nested expressions and derived tables
+     *   create_table  CREATE TABLE with many columns and constraints
+     *   bulk_strings  indented INSERT of 4 KB string literals
+     */
+    std::vector<Workload> corpus();
+}
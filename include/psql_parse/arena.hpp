@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace psql_parse {
+
+	/*
+	 * Bump allocator for AST nodes.
+	 *
+	 * Memory is handed out from a chain of chunks and is only given back
+	 * as a whole by reset() or when the arena is destroyed. Chunks are kept
+	 * across reset(), so an arena that is reused for many parses stops
+	 * calling malloc once it has grown to the size of the largest tree.
+	 *
+	 * The arena never runs destructors; whoever placed an object in the
+	 * arena (see box / Ownership::ARENA) is responsible for that.
+	 */
+	class Arena {
+		struct Chunk {
+			Chunk* next;
+			std::size_t size;
+
+			char* begin() { return reinterpret_cast<char*>(this + 1); }
+			char* end() { return begin() + size; }
+		};
+
+		Chunk* head_;
+		Chunk* current_;
+		char* cursor_;
+		char* limit_;
+
+		std::size_t chunk_size_;
+		std::size_t used_;
+		std::size_t reserved_;
+
+		void* allocateSlow(std::size_t size, std::size_t align);
+
+	public:
+		static constexpr std::size_t DEFAULT_CHUNK_SIZE = 32 * 1024;
+
+		explicit Arena(std::size_t chunk_size = DEFAULT_CHUNK_SIZE);
+		~Arena();
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		void* allocate(std::size_t size, std::size_t align) {
+			auto addr = reinterpret_cast<std::size_t>(cursor_);
+			auto aligned = (addr + align - 1) & ~(align - 1);
+			if (cursor_ != nullptr && aligned + size <= reinterpret_cast<std::size_t>(limit_)) {
+				cursor_ = reinterpret_cast<char*>(aligned + size);
+				used_ += size;
+				return reinterpret_cast<void*>(aligned);
+			}
+			return allocateSlow(size, align);
+		}
+
+		template<class T, class... Args>
+		T* make(Args&&... args) {
+			void* mem = allocate(sizeof(T), alignof(T));
+			return ::new (mem) T(std::forward<Args>(args)...);
+		}
+
+		/*
+		 * Invalidates everything allocated so far, keeps the chunks.
+		 */
+		void reset();
+
+		/* A position in the arena to rewind() to */
+		struct Mark {
+			Chunk* chunk;
+			char* cursor;
+			std::size_t used;
+		};
+
+		[[nodiscard]] Mark mark() const { return { current_, cursor_, used_ }; }
+
+		/*
+		 * Invalidates everything allocated since mark was taken, keeps
+		 * the chunks. Objects in that memory must have been destroyed.
+		 */
+		void rewind(const Mark& mark);
+
+		/*
+		 * Frees the chunks that are not in use, except for as many as fit
+		 * in keep bytes. After reset(), none are in use.
+		 */
+		void trim(std::size_t keep);
+
+		/* Bytes handed out since the last reset() */
+		[[nodiscard]] std::size_t bytesUsed() const { return used_; }
+
+		/* Bytes held in chunks */
+		[[nodiscard]] std::size_t bytesReserved() const { return reserved_; }
+
+		/* The arena AST containers allocate from on this thread, if any */
+		[[nodiscard]] static Arena* current() noexcept { return current_arena_; }
+
+	private:
+		friend class ArenaScope;
+
+		static inline thread_local Arena* current_arena_ = nullptr;
+	};
+
+	/*
+	 * Makes arena the current one of this thread until the scope ends;
+	 * nullptr makes containers allocate from the heap again.
+	 */
+	class ArenaScope {
+		Arena* previous_;
+
+	public:
+		explicit ArenaScope(Arena* arena) noexcept : previous_(Arena::current_arena_) {
+			Arena::current_arena_ = arena;
+		}
+		~ArenaScope() { Arena::current_arena_ = previous_; }
+
+		ArenaScope(const ArenaScope&) = delete;
+		ArenaScope& operator=(const ArenaScope&) = delete;
+	};
+
+	/*
+	 * Allocator of the containers inside AST nodes (see List). A container
+	 * takes its memory from the arena that was current when it was
+	 * created, like the nodes around it, or from the heap if there was
+	 * none; copies allocate from whatever is current at the time. Giving
+	 * back arena memory is a no-op, it is reclaimed with the arena.
+	 */
+	template <class T>
+	class ArenaAllocator {
+		Arena* arena_;
+
+		template <class U>
+		friend class ArenaAllocator;
+
+	public:
+		using value_type = T;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		ArenaAllocator() noexcept : arena_(Arena::current()) { }
+
+		template <class U>
+		ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena_) { }
+
+		T* allocate(std::size_t n) {
+			if (arena_ != nullptr) {
+				return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+			}
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+
+		void deallocate(T* ptr, std::size_t n) noexcept {
+			if (arena_ == nullptr) {
+				::operator delete(ptr, n * sizeof(T));
+			}
+		}
+
+		ArenaAllocator select_on_container_copy_construction() const noexcept {
+			return ArenaAllocator();
+		}
+
+		friend bool operator==(const ArenaAllocator& l, const ArenaAllocator& r) noexcept {
+			return l.arena_ == r.arena_;
+		}
+	};
+}
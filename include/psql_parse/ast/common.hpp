@@ -1,10 +1,14 @@
 #pragma once
 
 #include "location.hh"
+#include "psql_parse/arena.hpp"
+#include "psql_parse/symbol.hpp"
 
+#include <compare>
 #include <memory>
 #include <variant>
 #include <optional>
+#include <tuple>
 #include <vector>
 
 #define DEFAULT_SPACESHIP(Type) \
@@ -13,22 +17,48 @@
 #define DEFAULT_EQ(Type) \
 	friend bool operator==(const Type&, const Type&) noexcept = default
 
+/*
+ * Every data member of an AST type, in declaration order, for code that
+ * treats all nodes alike (see flat.hpp). The Node base is not listed.
+ */
+#define MEMBERS(...) \
+	auto members() { return std::tie(__VA_ARGS__); } \
+	auto members() const { return std::tie(__VA_ARGS__); }
+
 namespace psql_parse {
 
+	/*
+	 * Base of every node that lives in a box. The source span is stored
+	 * inline and set by the NodeFactory; it does not take part in
+	 * comparisons, so trees parsed from differently formatted input
+	 * still compare equal.
+	 */
 	struct Node {
-		const location loc;
-	};
+		location loc;
 
+		friend bool operator==(const Node&, const Node&) noexcept { return true; }
+		friend std::strong_ordering operator<=>(const Node&, const Node&) noexcept {
+			return std::strong_ordering::equal;
+		}
+	};
 
+	using Name = Symbol;
 
-	using Name = std::string;
+	/*
+	 * The sequences inside nodes. While a tree is parsed into an arena,
+	 * their storage comes from the arena as well (see ArenaAllocator).
+	 */
+	template <class T>
+	using List = std::vector<T, ArenaAllocator<T>>;
 
-	struct QualifiedName {
+	struct QualifiedName : Node {
         DEFAULT_SPACESHIP(QualifiedName);
+        MEMBERS(qualifier, name);
 
-        std::vector<Name> qualifier;
+        List<Name> qualifier;
 		Name name;
 
+        QualifiedName();
         explicit QualifiedName(Name name);
 	};
 
@@ -43,9 +73,55 @@ namespace psql_parse {
 		NATIONAL
 	};
 
+	/*
+	 * Who releases the node a box points to:
+	 * HEAP nodes are deleted, ARENA nodes are only destroyed, their
+	 * memory is released together with the arena that holds them.
+	 */
+	enum class Ownership {
+		HEAP,
+		ARENA
+	};
+
+	namespace box_detail {
+		using destroyer = void (*)(void*);
+
+		/*
+		 * Destroying a node destroys the boxes in it, which would destroy
+		 * their nodes in turn, one level of native stack per level of the
+		 * tree. A node released while another one is being destroyed is
+		 * only queued instead; the outermost release destroys the queue
+		 * in a loop, so freeing a tree of any depth takes a few frames.
+		 */
+		void release(void* node, destroyer destroy);
+
+		template <class T>
+		void destroyNode(void* node) {
+			static_cast<T*>(node)->~T();
+		}
+
+		template <class T>
+		void deleteNode(void* node) {
+			delete static_cast<T*>(node);
+		}
+	}
+
+	struct box_deleter {
+		Ownership owner = Ownership::HEAP;
+
+		template <class T>
+		void operator()(T* ptr) const {
+			if (owner == Ownership::ARENA) {
+				box_detail::release(ptr, &box_detail::destroyNode<T>);
+			} else {
+				box_detail::release(ptr, &box_detail::deleteNode<T>);
+			}
+		}
+	};
+
 	template <class T>
 	class box {
-		std::unique_ptr<T> ref_;
+		std::unique_ptr<T, box_deleter> ref_;
 
 	public:
 		box()
@@ -54,6 +130,9 @@ namespace psql_parse {
 		box(T* t)
 		: ref_(t) {}
 
+		box(T* t, Ownership owner)
+		: ref_(t, box_deleter { owner }) {}
+
 		template <class... Args>
 		static box make(Args... args) {
 			return box(new T(std::forward<Args>(args)...));
@@ -54,11 +54,12 @@ namespace psql_parse {
 		PRIMARY_KEY
 	};
 
-	struct References {
+	struct References : Node {
 		DEFAULT_EQ(References);
+		MEMBERS(rel_name, col_names, match_type, action);
 
 		box<QualifiedName> rel_name;
-		std::vector<Name> col_names;
+		List<Name> col_names;
 		MatchOption match_type;
 		ReferentialTriggeredAction action;
 	};
@@ -69,6 +70,7 @@ namespace psql_parse {
 
 	struct NamedColumnConstraint {
 		DEFAULT_EQ(NamedColumnConstraint);
+		MEMBERS(name, constraint);
 		std::optional<box<QualifiedName>> name = std::nullopt;
 		std::variant<
 				ConstraintType,
@@ -77,11 +79,12 @@ namespace psql_parse {
 
 	struct ColumnDef {
 		DEFAULT_EQ(ColumnDef);
+		MEMBERS(name, type, col_default, col_constraint, collate);
 
 		Name name;
         DataType type;
 		std::optional<ColumnDefault> col_default;
-		std::vector<NamedColumnConstraint> col_constraint;
+		List<NamedColumnConstraint> col_constraint;
 		std::optional<box<QualifiedName>> collate;
 
 		// required by bison
@@ -92,15 +95,18 @@ namespace psql_parse {
 
 	struct TableUniqueConstraint {
 		DEFAULT_EQ(TableUniqueConstraint);
-		std::vector<Name> column_names;
+		MEMBERS(column_names);
+		List<Name> column_names;
 	};
 	struct TablePrimaryKeyConstraint {
 		DEFAULT_EQ(TablePrimaryKeyConstraint);
-		std::vector<Name> column_names;
+		MEMBERS(column_names);
+		List<Name> column_names;
 	};
 	struct TableForeignKeyConstraint {
 		DEFAULT_EQ(TableForeignKeyConstraint);
-		std::vector<Name> column_names;
+		MEMBERS(column_names, references);
+		List<Name> column_names;
 		box<References> references;
 	};
 
@@ -109,15 +115,18 @@ namespace psql_parse {
 			TablePrimaryKeyConstraint,
 			TableForeignKeyConstraint>;
 
-	struct CreateStatement {
+	struct CreateStatement : Node {
+		MEMBERS(rel_name, temp, on_commit, column_defs, table_constraints);
+
 		box<QualifiedName> rel_name;
 		std::optional<Temporary> temp = std::nullopt;
 		std::optional<OnCommit> on_commit = std::nullopt;
-		std::vector<ColumnDef> column_defs;
-		std::vector<TableConstraint> table_constraints;
+		List<ColumnDef> column_defs;
+		List<TableConstraint> table_constraints;
 
+		CreateStatement();
 		explicit CreateStatement(box<QualifiedName> relName);
-		CreateStatement(box<QualifiedName> relName, std::optional<Temporary> temp, std::optional<OnCommit> onCommit, std::vector<std::variant<ColumnDef, TableConstraint>> elements);
+		CreateStatement(box<QualifiedName> relName, std::optional<Temporary> temp, std::optional<OnCommit> onCommit, List<std::variant<ColumnDef, TableConstraint>> elements);
 	};
 }
 
@@ -65,6 +65,7 @@ namespace psql_parse {
 
     struct UserDefinedType {
         DEFAULT_EQ(UserDefinedType);
+        MEMBERS(name);
 
         box<QualifiedName> name;
     };
@@ -105,29 +106,33 @@ namespace psql_parse {
      * non-predefined  / recursive types
      */
 
-    struct RowType {
+    struct RowType : Node {
         DEFAULT_EQ(RowType);
+        MEMBERS(fields);
 
         using FieldDef = std::pair<Name, DataType>;
-        std::vector<FieldDef> fields;
+        List<FieldDef> fields;
     };
 
-    struct RefType {
+    struct RefType : Node {
         DEFAULT_EQ(RefType);
+        MEMBERS(type, scope);
 
         UserDefinedType type;
         std::optional<box<QualifiedName>> scope;
     };
 
-    struct ArrayType {
+    struct ArrayType : Node {
         DEFAULT_EQ(ArrayType);
+        MEMBERS(type, max_cardinality);
 
         DataType type;
         std::optional<uint64_t> max_cardinality;
     };
 
-    struct MultiSetType {
+    struct MultiSetType : Node {
         DEFAULT_EQ(MultiSetType);
+        MEMBERS(type);
 
         DataType type;
     };
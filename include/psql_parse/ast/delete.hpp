@@ -3,13 +3,15 @@
 #include "expr.hpp"
 
 namespace psql_parse {
-    struct DeleteStatement {
+    struct DeleteStatement : Node {
         DEFAULT_EQ(DeleteStatement);
+        MEMBERS(table_name, only, where);
 
         box<QualifiedName> table_name;
         bool only;
         std::optional<Expression> where;
 
+        DeleteStatement();
         explicit DeleteStatement(box<QualifiedName> tableName, bool only);
     };
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ namespace psql_parse {
 	struct FloatLiteral;
 	struct StringLiteral;
     struct BooleanLiteral;
+	struct Param;
 	struct UnaryOp;
 	struct BinaryOp;
 	struct RowSubquery;
@@ -47,6 +48,7 @@ namespace psql_parse {
 			box<FloatLiteral>,
 			box<StringLiteral>,
             box<BooleanLiteral>,
+			box<Param>,
 			box<UnaryOp>,
 			box<BinaryOp>,
 			box<AliasExpr>,
@@ -73,6 +75,12 @@ namespace psql_parse {
 			box<Rollup>,
 			box<Cube>>;
 
+	using Literal = std::variant<
+			box<IntegerLiteral>,
+			box<FloatLiteral>,
+			box<StringLiteral>,
+			box<BooleanLiteral>>;
+
 	using RelExpression = std::variant<
 			box<JoinExpr>,
 			box<TableName>,
@@ -83,46 +91,56 @@ namespace psql_parse {
 			box<Query>>;
 	
 	/// <expr> AS <name>
-	struct AliasExpr {
+	struct AliasExpr : Node {
 		DEFAULT_EQ(AliasExpr);
+		MEMBERS(name, expr);
 
 		Name name;
 		Expression expr;
 
-		AliasExpr(std::string name, Expression expr);
+		AliasExpr();
+		AliasExpr(Name name, Expression expr);
 	};
 
-    struct Asterisk {
+    struct Asterisk : Node {
         DEFAULT_EQ(Asterisk);
+        MEMBERS();
     };
 
-    struct IntegerLiteral {
+    struct IntegerLiteral : Node {
 		DEFAULT_EQ(IntegerLiteral);
+		MEMBERS(value);
 
 		std::uint64_t value;
 
+		IntegerLiteral();
 		explicit IntegerLiteral(std::uint64_t value);
 	};
 
-    struct FloatLiteral {
+    struct FloatLiteral : Node {
 		DEFAULT_EQ(FloatLiteral);
+		MEMBERS(value);
 
         double value;
 
+        FloatLiteral();
         explicit FloatLiteral(double value);
 	};
 
-	struct StringLiteral {
+	struct StringLiteral : Node {
 		DEFAULT_EQ(StringLiteral);
+		MEMBERS(value, type);
 
 		std::string value;
 		StringLiteralType type;
 
+		StringLiteral();
 		StringLiteral(std::string&& value, StringLiteralType type);
 	};
 
-    struct BooleanLiteral {
+    struct BooleanLiteral : Node {
         DEFAULT_EQ(BooleanLiteral);
+        MEMBERS(value);
 
         enum class Val {
             TRUE,
@@ -132,38 +150,57 @@ namespace psql_parse {
 
         Val value;
 
+        BooleanLiteral();
         explicit BooleanLiteral(Val value);
     };
 
+	/// $<number>, a placeholder for a value supplied separately
+	struct Param : Node {
+		DEFAULT_EQ(Param);
+		MEMBERS(number);
+
+		std::uint64_t number;
+
+		Param();
+		explicit Param(std::uint64_t number);
+	};
+
 
-	struct Var {
+	struct Var : Node {
 		DEFAULT_EQ(Var);
+		MEMBERS(name);
 
 		Name name;
 
-		explicit Var(std::string);
+		Var();
+		explicit Var(Name);
 	};
 
-	struct Collate {
+	struct Collate : Node {
 		DEFAULT_EQ(Collate);
+		MEMBERS(var, collation);
 
 		Expression var;
 		box<QualifiedName> collation;
 
+		Collate();
 		Collate(Expression var, box<QualifiedName> collation);
 	};
 
-	struct IsExpr {
+	struct IsExpr : Node {
 		DEFAULT_EQ(IsExpr);
+		MEMBERS(inner, truth_value);
 
 		Expression inner;
 		box<BooleanLiteral> truth_value;
 
+		IsExpr();
 		IsExpr(Expression inner, box<BooleanLiteral> truth_value);
 	};
 
-	struct UnaryOp {
+	struct UnaryOp : Node {
 		DEFAULT_EQ(UnaryOp);
+		MEMBERS(op, inner);
 
 		enum class Op {
 			NOT,
@@ -173,6 +210,7 @@ namespace psql_parse {
 		Op op;
 		Expression inner;
 
+		UnaryOp();
 		UnaryOp(Op op, Expression inner);
 
 		static UnaryOp* Not(Expression expr) {
@@ -180,8 +218,9 @@ namespace psql_parse {
 		}
 	};
 
-	struct BinaryOp {
+	struct BinaryOp : Node {
 		DEFAULT_EQ(BinaryOp);
+		MEMBERS(op, left, right);
 
 		enum class Op {
 			OR, AND,
@@ -196,29 +235,35 @@ namespace psql_parse {
 		Expression left;
 		Expression right;
 
+		BinaryOp();
 		BinaryOp(Expression left, Op op, Expression right);
 	};
 
-	struct TableName {
+	struct TableName : Node {
 		DEFAULT_EQ(TableName);
+		MEMBERS(name);
 
 		box<QualifiedName> name;
 
+		TableName();
 		explicit TableName(box<QualifiedName> name);
 	};
 
-    struct TableAlias {
+    struct TableAlias : Node {
         DEFAULT_EQ(TableAlias);
+        MEMBERS(name, columns, expression);
 
         Name name;
-        std::vector<Name> columns;
+        List<Name> columns;
         RelExpression expression;
 
+        TableAlias();
         explicit TableAlias(Name name);
     };
 
-	struct JoinExpr {
+	struct JoinExpr : Node {
 		DEFAULT_EQ(JoinExpr);
+		MEMBERS(kind, natural, qualifier, columns, first, second);
 
 		enum class Kind {
 			FULL,
@@ -230,11 +275,12 @@ namespace psql_parse {
 		Kind kind;
 		bool natural;
 		std::optional<Expression> qualifier;
-		std::vector<Name> columns;
+		List<Name> columns;
 
 		RelExpression first;
 		RelExpression second;
 
+		JoinExpr();
 		JoinExpr(RelExpression first, Kind kind, RelExpression second);
 
 		void setNatural();
@@ -246,8 +292,9 @@ namespace psql_parse {
 		DISTINCT
 	};
 
-	struct SortSpec {
+	struct SortSpec : Node {
 		DEFAULT_EQ(SortSpec);
+		MEMBERS(expr, order, null_order);
 
 		enum class Order {
 			ASC,
@@ -270,35 +317,41 @@ namespace psql_parse {
 
 	struct GroupClause {
 		DEFAULT_EQ(GroupClause);
+		MEMBERS(group_quantifier, group_clause);
 
 		std::optional<SetQuantifier> group_quantifier;
-		std::vector<Grouping> group_clause;
+		List<Grouping> group_clause;
 	};
 
-    struct WithSpec {
+    struct WithSpec : Node {
         DEFAULT_EQ(WithSpec);
+        MEMBERS(name, columns, query);
 
         Name name;
-        std::optional<std::vector<Name>> columns;
+        std::optional<List<Name>> columns;
         box<Query> query;
 
-        explicit WithSpec(std::string name, box<Query> query);
+        WithSpec();
+        explicit WithSpec(Name name, box<Query> query);
     };
 
-    struct WithClause {
+    struct WithClause : Node {
         DEFAULT_EQ(WithClause);
+        MEMBERS(recursive, elements);
 
         bool recursive;
-        std::vector<box<WithSpec>> elements;
+        List<box<WithSpec>> elements;
 
         WithClause();
     };
 
-	struct Window {
+	struct Window : Node {
 		DEFAULT_EQ(Window);
+		MEMBERS(window_name, existing_window, partition, sort, frame);
 
 		struct Frame {
 			DEFAULT_EQ(Frame);
+			MEMBERS(unit, start, end, exclude);
 
 			enum class Unit {
 				ROWS,
@@ -337,20 +390,21 @@ namespace psql_parse {
 		/*
 		 * Empty vector = no partition clause
 		 */
-		std::vector<Expression> partition;
-		std::vector<box<SortSpec>> sort;
+		List<Expression> partition;
+		List<box<SortSpec>> sort;
 		std::optional<Frame> frame;
 	};
 
-	struct SelectExpr {
+	struct SelectExpr : Node {
 		DEFAULT_EQ(SelectExpr);
+		MEMBERS(target_list, from_clause, where_clause, group_clause, having_clause, window_clause, set_quantifier);
 
-		std::vector<Expression> target_list;
-		std::vector<RelExpression> from_clause;
+		List<Expression> target_list;
+		List<RelExpression> from_clause;
 		std::optional<Expression> where_clause;
 		std::optional<GroupClause> group_clause;
 		std::optional<Expression> having_clause;
-		std::vector<box<Window>> window_clause;
+		List<box<Window>> window_clause;
 		std::optional<SetQuantifier> set_quantifier;
 
 		SelectExpr();
@@ -358,6 +412,7 @@ namespace psql_parse {
 
 	struct Fetch {
 		DEFAULT_EQ(Fetch);
+		MEMBERS(kind, with_ties, percent, value);
 
 		enum class Kind {
 			FIRST,
@@ -371,20 +426,23 @@ namespace psql_parse {
 		std::optional<box<IntegerLiteral>> value;
 	};
 
-	struct Query {
+	struct Query : Node {
 		DEFAULT_EQ(Query);
+		MEMBERS(expr, with, order, offset, fetch);
 
 		RelExpression expr;
         std::optional<box<WithClause>> with;
-		std::vector<box<SortSpec>> order;
+		List<box<SortSpec>> order;
 		std::optional<box<IntegerLiteral>> offset;
 		std::optional<Fetch> fetch;
 
+		Query();
 		explicit Query(RelExpression expr);
 	};
 
-	struct SetOp {
+	struct SetOp : Node {
 		DEFAULT_EQ(SetOp);
+		MEMBERS(op, left, right, quantifier);
 
 		enum class Op {
 			UNION,
@@ -397,114 +455,135 @@ namespace psql_parse {
 		RelExpression right;
 		std::optional<SetQuantifier> quantifier;
 
+		SetOp();
 		SetOp(RelExpression left, Op op, RelExpression right);
 	};
 
-	struct ValuesExpr {
+	struct ValuesExpr : Node {
 		DEFAULT_EQ(ValuesExpr);
+		MEMBERS(rows);
 
-		std::vector<Expression> rows;
+		List<Expression> rows;
 
-		explicit ValuesExpr(std::vector<Expression> rows);
+		ValuesExpr();
+		explicit ValuesExpr(List<Expression> rows);
 	};
 
-	struct RowExpr {
+	struct RowExpr : Node {
 		DEFAULT_EQ(RowExpr);
+		MEMBERS(exprs);
 
-		std::vector<Expression> exprs;
+		List<Expression> exprs;
 
 		RowExpr();
-		explicit RowExpr(std::vector<Expression> exprs);
+		explicit RowExpr(List<Expression> exprs);
 	};
 
-	struct GroupingSet {
+	struct GroupingSet : Node {
 		DEFAULT_EQ(GroupingSet);
+		MEMBERS(columns);
 
-		std::vector<Expression> columns;
+		List<Expression> columns;
 
 		GroupingSet();
 	};
 
-	struct GroupingSets {
+	struct GroupingSets : Node {
 		DEFAULT_EQ(GroupingSets);
+		MEMBERS(sets);
 
-		std::vector<Grouping> sets;
+		List<Grouping> sets;
 
 		GroupingSets();
 	};
 
-	struct Rollup {
+	struct Rollup : Node {
 		DEFAULT_EQ(Rollup);
+		MEMBERS(sets);
 
-		std::vector<box<GroupingSet>> sets;
+		List<box<GroupingSet>> sets;
 
 		Rollup();
 	};
 
-	struct Cube {
+	struct Cube : Node {
 		DEFAULT_EQ(Cube);
+		MEMBERS(sets);
 
-		std::vector<box<GroupingSet>> sets;
+		List<box<GroupingSet>> sets;
 
 		Cube();
 	};
 
-	struct RowSubquery {
+	struct RowSubquery : Node {
 		DEFAULT_EQ(RowSubquery);
+		MEMBERS(subquery);
 
 		RelExpression subquery;
 
+		RowSubquery();
 		explicit RowSubquery(RelExpression expr);
 	};
 
-	struct BetweenPred {
+	struct BetweenPred : Node {
 		DEFAULT_EQ(BetweenPred);
+		MEMBERS(val, low, high, symmetric);
 
 		Expression val;
 		Expression low;
 		Expression high;
 		bool symmetric;
 
+		BetweenPred();
 		BetweenPred(Expression val, Expression low, Expression high);
 	};
 
-	struct InPred {
+	struct InPred : Node {
 		DEFAULT_EQ(InPred);
+		MEMBERS(val, rows);
 
 		Expression val;
 		RelExpression rows;
 
+		InPred();
 		InPred(Expression val, RelExpression rows);
 	};
 
-	struct LikePred {
+	struct LikePred : Node {
 		DEFAULT_EQ(LikePred);
+		MEMBERS(val, pattern, escape);
 
 		Expression val;
 		Expression pattern;
 		std::optional<Expression> escape;
 
+		LikePred();
 		LikePred(Expression val, Expression pattern);
 	};
 
-	struct ExistsPred {
+	struct ExistsPred : Node {
 		DEFAULT_EQ(ExistsPred);
+		MEMBERS(subquery);
 
 		box<Query> subquery;
 
+		ExistsPred();
 		explicit ExistsPred(box<Query> subquery);
 	};
 
-	struct UniquePred {
+	struct UniquePred : Node {
 		DEFAULT_EQ(UniquePred);
+		MEMBERS(subquery);
 
 		box<Query> subquery;
 
+		UniquePred();
 		explicit UniquePred(box<Query> subquery);
 	};
 
-    struct AggregateExpr {
+    struct AggregateExpr : Node {
         DEFAULT_EQ(AggregateExpr);
+        MEMBERS(op, argument, quantifier, filter);
 
         enum class Op {
             AVG, MAX, MIN, SUM, COUNT,
@@ -521,6 +600,7 @@ namespace psql_parse {
         std::optional<SetQuantifier> quantifier;
         std::optional<Expression> filter;
 
+        AggregateExpr();
         AggregateExpr(Op op, Expression argument);
     };
 }
@@ -3,7 +3,7 @@
 #include "expr.hpp"
 
 namespace psql_parse {
-    struct InsertStatement {
+    struct InsertStatement : Node {
 
         enum class Override {
             USER_VALUE,
@@ -15,12 +15,14 @@ namespace psql_parse {
         };
 
         DEFAULT_EQ(InsertStatement);
+        MEMBERS(table_name, column_names, override, source);
 
         box<QualifiedName> table_name;
-        std::vector<Name> column_names;
+        List<Name> column_names;
         std::optional<Override> override;
         std::variant<Default, box<Query>> source;
 
+        InsertStatement();
         explicit InsertStatement(box<QualifiedName> tableName);
     };
 }
\ No newline at end of file
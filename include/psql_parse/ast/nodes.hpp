@@ -1,30 +1,62 @@
 #pragma once
 
-#include <unordered_map>
+#include <type_traits>
 
+#include "psql_parse/arena.hpp"
+#include "psql_parse/stats.hpp"
 #include "expr.hpp"
 namespace psql_parse {
 	class NodeFactory {
 
 	protected:
-		std::unordered_map<void *, location> locations;
+		/* nullptr: nodes are allocated on the heap */
+		Arena* arena_ = nullptr;
+
+		/* Where nodes are counted, in builds with PSQL_PARSE_STATS */
+		ParseStats* stats_ = nullptr;
+
+		template<class T, class... Args>
+		T* construct(location loc, Args... args) {
+			// Aggregates take their Node base as the first initializer
+			if constexpr (std::is_aggregate_v<T>) {
+				if (arena_ == nullptr) {
+					return new T(Node { loc }, std::forward<Args>(args)...);
+				}
+				return arena_->make<T>(Node { loc }, std::forward<Args>(args)...);
+			} else {
+				T* ptr = arena_ == nullptr
+						? new T(std::forward<Args>(args)...)
+						: arena_->make<T>(std::forward<Args>(args)...);
+				ptr->loc = loc;
+				return ptr;
+			}
+		}
 
 	public:
 		template<class T, class... Args>
-		auto node(location loc, Args... args) -> T* {
-			T* ptr = new T(std::forward<Args>(args)...);
-			locations[ptr] = loc;
-			return ptr;
+		auto node(location loc, Args... args) -> box<T> {
+#ifdef PSQL_PARSE_STATS
+			if (stats_ != nullptr) {
+				stats_->nodes[nodeIndex<T>]++;
+				stats_->node_bytes += sizeof(T);
+			}
+#endif
+			T* ptr = construct<T>(loc, std::forward<Args>(args)...);
+			return box<T>(ptr, arena_ == nullptr ? Ownership::HEAP : Ownership::ARENA);
 		}
 
 		template <class T, class... Args>
-		auto notNode(location loc, Args...args) -> UnaryOp* {
-			T* ptr = node<T>(loc, std::forward<Args>(args)...);
-			return node<UnaryOp>(loc, UnaryOp::Op::NOT, ptr);
+		auto notNode(location loc, Args...args) -> box<UnaryOp> {
+			box<T> inner = node<T>(loc, std::forward<Args>(args)...);
+			return node<UnaryOp>(loc, UnaryOp::Op::NOT, std::move(inner));
+		}
+
+		void setArena(Arena* arena) {
+			arena_ = arena;
 		}
 
-		void clear() {
-			locations.clear();
+		void setStats(ParseStats* stats) {
+			stats_ = stats;
 		}
 
 	};
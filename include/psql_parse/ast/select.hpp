@@ -3,11 +3,13 @@
 #include "expr.hpp"
 
 namespace psql_parse {
-	struct SelectStatement {
+	struct SelectStatement : Node {
 		DEFAULT_EQ(SelectStatement);
+		MEMBERS(rel_expr);
 
 		box<Query> rel_expr;
 
+		SelectStatement();
 		explicit SelectStatement(box<Query> queryExpr);
 	};
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <type_traits>
 
 #include "create.hpp"
 #include "delete.hpp"
@@ -13,4 +15,44 @@ namespace psql_parse {
             box<InsertStatement>,
             box<DeleteStatement>,
 			box<SelectStatement>>;
-}
\ No newline at end of file
+
+	template <class... Ts>
+	struct TypeList {};
+
+	/* Every type held in a box somewhere in a Statement */
+	using NodeTypes = TypeList<
+			CreateStatement, InsertStatement, DeleteStatement, SelectStatement,
+			JoinExpr, TableName, TableAlias, SelectExpr, ValuesExpr, SetOp, Query,
+			WithClause, WithSpec, Window,
+			AliasExpr, Asterisk, IntegerLiteral, FloatLiteral, StringLiteral, BooleanLiteral, Param,
+			UnaryOp, BinaryOp, RowExpr, RowSubquery, Var, Collate, IsExpr,
+			BetweenPred, InPred, LikePred, ExistsPred, UniquePred, SortSpec,
+			GroupingSet, GroupingSets, Rollup, Cube, AggregateExpr,
+			QualifiedName, References, RowType, RefType, ArrayType, MultiSetType>;
+
+	namespace node_detail {
+		template <class T, class... Ts>
+		constexpr std::size_t indexOf(TypeList<Ts...>) {
+			std::size_t index = 0;
+			((std::is_same_v<T, Ts> ? false : (++index, true)) && ...);
+			return index;
+		}
+
+		template <class... Ts>
+		constexpr std::size_t countOf(TypeList<Ts...>) { return sizeof...(Ts); }
+	}
+
+	/* Position of a node type in NodeTypes */
+	template <class T>
+	constexpr std::size_t nodeIndex = node_detail::indexOf<T>(NodeTypes());
+
+	constexpr std::size_t nodeTypeCount = node_detail::countOf(NodeTypes());
+
+	/*
+	 * Source span of the node held by a (non-empty) variant. Nodes
+	 * reached through a box carry their span in Node::loc.
+	 */
+	const location& locationOf(const Expression& expr);
+	const location& locationOf(const RelExpression& expr);
+	const location& locationOf(const Statement& stmt);
+}
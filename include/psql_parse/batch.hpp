@@ -0,0 +1,28 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "psql_parse/ast/stmt.hpp"
+
+namespace psql_parse {
+
+	/*
+	 * Parse independent statements on a pool of worker threads.
+	 *
+	 * Every worker owns one driver (and with it one scanner) for the
+	 * whole batch. Work is split into one contiguous range per worker;
+	 * a worker that runs out steals half of the largest remaining range
+	 * of another worker.
+	 *
+	 * The result has one entry per input, in input order, holding
+	 * std::nullopt where the input did not parse. Nodes are allocated on
+	 * the heap, so results outlive the workers.
+	 *
+	 * threads == 0 uses std::thread::hardware_concurrency().
+	 */
+	auto parseBatch(std::span<const std::string_view> queries, unsigned threads = 0)
+		-> std::vector<std::optional<Statement>>;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "psql_parse/ast/stmt.hpp"
+
+namespace psql_parse {
+
+	/*
+	 * Thread-safe, size-bounded LRU cache from query text to its parse.
+	 *
+	 * Keys are the exact query bytes: two texts that differ only in
+	 * whitespace or case are different entries. Entries are split over
+	 * independently locked shards by the hash of the text, and every
+	 * shard evicts its least recently used entry once it holds more
+	 * than capacity / shards statements.
+	 *
+	 * Cached statements are immutable and shared: get() hands out a
+	 * shared_ptr to a statement owned jointly by the cache and every
+	 * caller still holding it. Eviction only drops the cache's
+	 * reference, so a statement stays valid for as long as the caller
+	 * keeps the pointer. Nodes are allocated on the heap, never in an
+	 * arena.
+	 *
+	 * On a miss the query is parsed outside the lock by a driver private
+	 * to the calling thread. Queries that do not parse are not cached
+	 * and yield nullptr.
+	 */
+	class ParseCache {
+	public:
+		struct Stats {
+			std::uint64_t hits;
+			std::uint64_t misses;
+			std::uint64_t evictions;
+			std::size_t size;
+		};
+
+		/* capacity must be at least 1; shards is capped at capacity */
+		explicit ParseCache(std::size_t capacity, unsigned shards = 16);
+		~ParseCache();
+
+		ParseCache(const ParseCache&) = delete;
+		ParseCache& operator=(const ParseCache&) = delete;
+
+		std::shared_ptr<const Statement> get(std::string_view query);
+
+		/* Drops every entry; statements still held by callers stay valid */
+		void clear();
+
+		[[nodiscard]] Stats stats() const;
+		[[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+	private:
+		struct Shard;
+
+		std::size_t capacity_;
+		unsigned shard_count_;
+		std::unique_ptr<Shard[]> shards_;
+	};
+}
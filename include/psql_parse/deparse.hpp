@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+#include "psql_parse/ast/stmt.hpp"
+
+namespace psql_parse {
+
+	/*
+	 * SQL text for a tree, in the dialect the parser reads: parsing the
+	 * text of a parsed statement gives a statement equal to it. Keywords
+	 * are upper case, every compound expression is in parentheses, and
+	 * names are quoted only where they would otherwise read as a keyword
+	 * or be folded to lower case.
+	 *
+	 * The text is appended to out, so a caller that reuses one buffer
+	 * for many statements stops allocating once it fits the longest.
+	 */
+	void deparse(const Statement& stmt, std::string& out);
+	void deparse(const Expression& expr, std::string& out);
+
+	/* A query expression, as it would follow INSERT INTO t */
+	void deparse(const RelExpression& expr, std::string& out);
+
+	std::string deparse(const Statement& stmt);
+}
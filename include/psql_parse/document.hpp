@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "psql_parse/driver.hpp"
+
+namespace psql_parse {
+
+	/*
+	 * A parsed script that follows the edits made to its text, for
+	 * editors that parse again on every keystroke. The text is split in
+	 * segments: a statement along with the ';' that ends it, the last
+	 * one without. An edit parses again from the start of the segment it
+	 * begins in, up to the first ';' after it that also ended a segment
+	 * before the edit; the segments after that are kept as they are.
+	 *
+	 * Locations in a segment's tree and diagnostics are counted from the
+	 * start of the segment, so they stay valid whatever happens to the
+	 * text before it. locate() places them in the current text; where
+	 * segments start is only summed up again when asked for.
+	 *
+	 * Syntax errors do not stop the parse, they are kept with the segment
+	 * they are in.
+	 */
+	class Document {
+	public:
+		/* Where a segment starts in the text */
+		struct Position {
+			std::size_t offset;
+			position::counter_type line;
+			position::counter_type column;
+		};
+
+		/* Parse all of text, which only has to stay alive during the call */
+		explicit Document(std::string_view text);
+
+		Document(const Document&) = delete;
+		Document& operator=(const Document&) = delete;
+
+		/*
+		 * Follow an edit that replaced removed bytes at offset with
+		 * inserted; text is all of the text after the edit.
+		 */
+		void edit(std::size_t offset, std::size_t removed, std::string_view inserted, std::string_view text);
+
+		/* The number of segments, at least one */
+		[[nodiscard]] std::size_t size() const { return segments_.size(); }
+
+		/* The statement of a segment, nullptr if it is empty or has an error */
+		[[nodiscard]] const Statement* statement(std::size_t segment) const;
+
+		/* Syntax errors of a segment, in input order */
+		[[nodiscard]] const std::vector<Diagnostic>& diagnostics(std::size_t segment) const;
+
+		[[nodiscard]] Position start(std::size_t segment) const;
+
+		/* The segment the byte at offset belongs to, the last one past the end */
+		[[nodiscard]] std::size_t segmentAt(std::size_t offset) const;
+
+		/* A location in a segment's tree or diagnostics, in the whole text */
+		[[nodiscard]] location locate(std::size_t segment, const location& loc) const;
+
+		/* The segments parsed by the last edit, or by the constructor */
+		[[nodiscard]] std::size_t reparsed() const { return reparsed_; }
+
+	private:
+		struct Segment {
+			// bytes, through the ';'
+			std::size_t length;
+			// newlines in those, and the bytes after the last one
+			position::counter_type lines;
+			std::size_t tail;
+			std::optional<Statement> statement;
+			std::vector<Diagnostic> diagnostics;
+		};
+
+		driver driver_;
+		std::vector<Segment> segments_;
+
+		// starts_[i] is up to date for i < valid_, the rest is summed up on demand
+		mutable std::vector<Position> starts_;
+		mutable std::size_t valid_;
+
+		std::size_t reparsed_;
+
+		/*
+		 * The segments of text from offset begin on. After each ';' more is
+		 * called with the offset past it; the parse stops there on false.
+		 */
+		std::vector<Segment> parse(std::string_view text, std::size_t begin,
+								   const std::function<bool(std::size_t)>& more);
+	};
+}
@@ -1,35 +1,200 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <vector>
 #include <optional>
+#include <string>
+#include <string_view>
 
+#include "psql_parse/arena.hpp"
 #include "psql_parse/ast/nodes.hpp"
 #include "psql_parse/scanner.hpp"
+#include "psql_parse/stats.hpp"
 
 namespace psql_parse {
 
+    /*
+     * Receives each statement of a script as soon as it has been parsed.
+     * The statement is destroyed when the callback returns, unless the
+     * callback moves it out (which is only safe without an arena).
+     */
+    using StatementCallback = std::function<void(Statement&)>;
+
+    /*
+     * Receives the rows of an INSERT ... VALUES list in batches, while
+     * the statement is still being parsed. The rows are destroyed when
+     * the callback returns, unless the callback moves them out (which
+     * is only safe without an arena).
+     */
+    using RowsCallback = std::function<void(const QualifiedName& table, std::vector<Expression>& rows)>;
+
+    /* A syntax error, at the location of the token it was found at */
+    struct Diagnostic {
+        location loc;
+        std::string message;
+    };
+
     class driver {
         friend class parser;
+        friend class Document;
 
         std::unique_ptr<scanner> scanner_;
+        // kept between parses along with its stack
+        std::unique_ptr<parser> parser_;
 
         bool trace_scanning_;
         bool trace_parsing_;
 
         std::ostream& scanner_err_;
 
+        bool use_arena_;
+
+        // declared before result_: nodes in the arena are destroyed first
+        Arena arena_;
+
 		Statement result_;
 
 		NodeFactory nf;
 
-        [[maybe_unused]] static void error(const psql_parse::location&, const std::string&);
+        // set while parsing a script, nullptr for a single statement
+        const StatementCallback* on_statement_;
+        std::size_t statements_;
+
+        // streaming of INSERT ... VALUES rows, see streamRows()
+        RowsCallback on_rows_;
+        std::size_t row_batch_;
+        std::vector<Expression> rows_;
+        Arena::Mark rows_mark_;
+        // table of the INSERT being parsed, nullptr outside of one
+        const QualifiedName* insert_table_;
+        // parenthesis depth, and the depth of the last VALUES keyword
+        std::size_t depth_;
+        std::size_t values_depth_;
+        // VALUES lists open around the parser, and which one streams
+        std::size_t values_lists_;
+        std::size_t streamed_list_;
+        bool streamed_;
+
+        // see stats(), only counted with PSQL_PARSE_STATS
+        ParseStats stats_;
+        StatsCollector* collector_;
+        std::uint64_t sampled_ns_;
+        std::uint64_t samples_;
+
+        // set by Document: called before the token after each ';' with
+        // the input offset past it, the parse ends there on false
+        std::function<bool(std::size_t)> on_boundary_;
+        bool at_boundary_;
+
+        // see recoverErrors()
+        bool recover_;
+        std::vector<Diagnostic> diagnostics_;
+
+        void error(const psql_parse::location&, const std::string&);
+
+        /*
+         * Called by the parser once it has skipped a statement with a
+         * syntax error; false if it should stop there instead.
+         */
+        bool resync();
+
+        void attach(std::istream& in);
+        void attach(std::string_view input);
+        bool run(const StatementCallback* on_statement);
+
+        /* Called by the parser for every statement it reduces */
+        void emit(Statement stmt, const location& loc);
+
+        /*
+         * The parser's yylex; tracks parentheses while rows are streamed,
+         * statement boundaries for a Document, and counts tokens in builds
+         * with stats
+         */
+        parser::symbol_type lex(std::size_t stack_depth = 0);
+        parser::symbol_type timedLex();
+
+        /* Called by the parser around the rows of every VALUES list */
+        void beginInsert(const QualifiedName& table);
+        void beginValues(const location& loc);
+        void addRow(List<Expression>& rows, Expression row);
+        List<Expression> endValues(List<Expression> rows);
+        void flushRows();
 
     public:
         driver();
 
         bool parse(std::istream& in);
 
+        /*
+         * Parse directly from caller memory, without going through an
+         * istream. The input only has to stay alive during the call.
+         */
+        bool parse(std::string_view input);
+
+        /*
+         * Parse a script of ';'-separated statements and hand each one to
+         * the callback as soon as it is complete. Statements are freed
+         * (and the arena is reset) after each callback, so memory does
+         * not grow with the length of the script. Returns false on the
+         * first syntax error; statements before it have been delivered.
+         */
+        bool parseScript(std::istream& in, const StatementCallback& callback);
+        bool parseScript(std::string_view input, const StatementCallback& callback);
+
 		Statement& getResult();
+
+        /*
+         * Allocate the nodes of each parse from an arena owned by the driver.
+         * The result is then only valid until the next call to parse() or
+         * until the driver is destroyed, whichever comes first.
+         */
+        void useArena(bool enable);
+
+        /*
+         * Hand the rows of an INSERT's VALUES list to the callback in
+         * batches of up to batch_size rows as soon as they are parsed,
+         * instead of collecting them in the tree: the ValuesExpr of the
+         * statement is left empty, and memory stays bounded however many
+         * rows there are. VALUES lists anywhere else are parsed as usual.
+         * A streamed list has to be the whole source of the INSERT, with
+         * no UNION or ORDER BY around it; that is a syntax error, after
+         * the rows before it have been delivered. An empty callback
+         * turns streaming off.
+         */
+        void streamRows(RowsCallback callback, std::size_t batch_size = 1024);
+
+        /*
+         * On a syntax error, skip to the next ';' and go on parsing instead
+         * of stopping. Errors are then collected in diagnostics() rather
+         * than printed, and parse() and parseScript() return false if
+         * there were any; statements without errors are still delivered.
+         */
+        void recoverErrors(bool enable);
+
+        /* The syntax errors of the last parse, in input order */
+        [[nodiscard]] const std::vector<Diagnostic>& diagnostics() const;
+
+        /*
+         * What the last parse cost, all zero unless the library is built
+         * with PSQL_PARSE_STATS
+         */
+        [[nodiscard]] const ParseStats& stats() const;
+
+        /* Add the stats of every parse to collector, nullptr to stop */
+        void collectStats(StatsCollector* collector);
+
+        /*
+         * Memory kept for the next parse: the arena and the scanner's
+         * buffers. Once they are big enough for the input, parsing into
+         * the arena does not allocate.
+         */
+        [[nodiscard]] std::size_t bytesReserved() const;
+
+        /*
+         * Give back what is kept beyond bytes, and the parser's stack.
+         * Drops the result of the last parse.
+         */
+        void trim(std::size_t bytes);
     };
 }
\ No newline at end of file
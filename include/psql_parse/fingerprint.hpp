@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+#include "psql_parse/ast/stmt.hpp"
+
+namespace psql_parse {
+
+	/*
+	 * Literal-insensitive query id, in the spirit of pg_stat_statements:
+	 * statements that only differ in the values of integer, float,
+	 * string or boolean literals get the same fingerprint. Node kinds,
+	 * operators, identifiers, literal kinds and the shape of every list
+	 * are part of the hash.
+	 *
+	 * Computed in one pass over the tree without allocating. The value
+	 * is stable across runs of the same build; identifiers contribute
+	 * std::hash of their text.
+	 */
+	std::uint64_t fingerprint(Statement& stmt);
+	std::uint64_t fingerprint(Expression& expr);
+	std::uint64_t fingerprint(RelExpression& expr);
+}
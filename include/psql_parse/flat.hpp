@@ -0,0 +1,441 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "psql_parse/arena.hpp"
+#include "psql_parse/ast/stmt.hpp"
+
+namespace psql_parse {
+
+	/*
+	 * Flat form of a statement: every node lives in a contiguous pool
+	 * for its type, and nodes refer to each other by 32-bit indices into
+	 * those pools instead of through pointers.
+	 *
+	 * The flat type of each AST type follows from its members():
+	 *   box<T>                    Ref<T>, an index into the pool of T
+	 *   List<X>                   Span<X>, a range in the pool of X
+	 *   std::string, Name         Text, a range in the text pool
+	 *   a type with members()     Flat<T>, its members flattened in order
+	 *   std::variant, optional    the same, over the flattened types
+	 *   std::pair                 FlatPair
+	 * Anything else is trivially copyable already and kept as it is.
+	 * Pool entries hold no pointers, so a tree can be copied, written
+	 * out and read back with memcpy, a fixed number of arrays at a time.
+	 */
+
+	template <class T>
+	struct Ref {
+		static constexpr std::uint32_t NONE = ~std::uint32_t(0);
+
+		/* NONE for an empty box */
+		std::uint32_t index = NONE;
+
+		explicit operator bool() const { return index != NONE; }
+		friend bool operator==(Ref, Ref) = default;
+	};
+
+	template <class X>
+	struct Span {
+		std::uint32_t offset = 0;
+		std::uint32_t size = 0;
+	};
+
+	struct Text {
+		std::uint32_t offset = 0;
+		std::uint32_t size = 0;
+	};
+
+	template <class A, class B>
+	struct FlatPair {
+		A first;
+		B second;
+	};
+
+	/* A std::tuple that stays trivially copyable */
+	template <class... Ts>
+	struct Record {};
+
+	template <class T, class... Ts>
+	struct Record<T, Ts...> {
+		T head;
+		[[no_unique_address]] Record<Ts...> tail;
+	};
+
+	template <class T>
+	concept Reflected = requires (const T& value) { value.members(); };
+
+	template <class T>
+	struct Flat;
+
+	namespace flat_detail {
+		template <class X>
+		struct FlatType {
+			static_assert(std::is_trivially_copyable_v<X>, "add members() to the AST type");
+			using type = X;
+		};
+
+		template <Reflected S>
+		struct FlatType<S> { using type = Flat<S>; };
+
+		template <>
+		struct FlatType<std::string> { using type = Text; };
+
+		/* Names are stored by their text, symbols are only valid in this process */
+		template <>
+		struct FlatType<Symbol> { using type = Text; };
+
+		template <class T>
+		struct FlatType<box<T>> { using type = Ref<T>; };
+
+		template <class X>
+		struct FlatType<List<X>> { using type = Span<X>; };
+
+		template <class X>
+		struct FlatType<std::optional<X>> { using type = std::optional<typename FlatType<X>::type>; };
+
+		template <class... Ts>
+		struct FlatType<std::variant<Ts...>> { using type = std::variant<typename FlatType<Ts>::type...>; };
+
+		template <class A, class B>
+		struct FlatType<std::pair<A, B>> { using type = FlatPair<typename FlatType<A>::type, typename FlatType<B>::type>; };
+
+		template <class Tuple>
+		struct RecordOf;
+
+		template <class... Ts>
+		struct RecordOf<std::tuple<Ts...>> {
+			using type = Record<typename FlatType<std::remove_cvref_t<Ts>>::type...>;
+		};
+
+		template <class S>
+		using MembersOf = decltype(std::declval<const S&>().members());
+
+		template <std::size_t I, class R>
+		constexpr auto& get(R& record) {
+			if constexpr (I == 0) {
+				return record.head;
+			} else {
+				return get<I - 1>(record.tail);
+			}
+		}
+
+		struct Flattener;
+		struct Validator;
+	}
+
+	template <class X>
+	using FlatOf = typename flat_detail::FlatType<X>::type;
+
+	template <class S>
+	struct Flat {
+		typename flat_detail::RecordOf<flat_detail::MembersOf<S>>::type members;
+	};
+
+	/* A source span without the file name */
+	struct FlatLocation {
+		std::uint32_t begin_line;
+		std::uint32_t begin_column;
+		std::uint32_t end_line;
+		std::uint32_t end_column;
+	};
+
+	/* Flattened nodes keep their source span */
+	template <class S> requires std::derived_from<S, Node>
+	struct Flat<S> {
+		FlatLocation loc;
+		typename flat_detail::RecordOf<flat_detail::MembersOf<S>>::type members;
+	};
+
+	/* Member I of a flattened S, I counting in the order of S::members() */
+	template <std::size_t I, class S>
+	constexpr auto& field(Flat<S>& flat) {
+		return flat_detail::get<I>(flat.members);
+	}
+
+	template <std::size_t I, class S>
+	constexpr const auto& field(const Flat<S>& flat) {
+		return flat_detail::get<I>(flat.members);
+	}
+
+	template <class S>
+	constexpr std::size_t memberCount = std::tuple_size_v<flat_detail::MembersOf<S>>;
+
+	/* Every type held in a box somewhere in a Statement */
+	using FlatNodeTypes = NodeTypes;
+
+	/* Every element type of a List somewhere in a Statement */
+	using FlatSpanTypes = TypeList<
+			Name, Expression, RelExpression, Grouping,
+			box<SortSpec>, box<WithSpec>, box<Window>, box<GroupingSet>,
+			ColumnDef, NamedColumnConstraint, TableConstraint, RowType::FieldDef>;
+
+	namespace flat_detail {
+		template <template <class> class Pool, class List>
+		struct Pools;
+
+		template <template <class> class Pool, class... Ts>
+		struct Pools<Pool, TypeList<Ts...>> { using type = std::tuple<Pool<Ts>...>; };
+
+		template <class T>
+		using NodeSpan = std::span<const Flat<T>>;
+
+		template <class X>
+		using ElementSpan = std::span<const FlatOf<X>>;
+
+		template <class T>
+		using NodeVector = std::vector<Flat<T>>;
+
+		template <class X>
+		using ElementVector = std::vector<FlatOf<X>>;
+	}
+
+	/*
+	 * Read-only access to a flat tree whose pools live elsewhere: in a
+	 * FlatTree, or in bytes written by write(), for example a mapped file.
+	 */
+	class FlatView {
+		flat_detail::Pools<flat_detail::NodeSpan, FlatNodeTypes>::type nodes_;
+		flat_detail::Pools<flat_detail::ElementSpan, FlatSpanTypes>::type spans_;
+		std::string_view text_;
+		FlatOf<Statement> root_;
+
+		friend class FlatTree;
+		friend struct flat_detail::Validator;
+
+	public:
+		/* Written into every blob, bumped whenever the encoding changes */
+		static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+		FlatView() = default;
+
+		/*
+		 * Append the tree to out as a self-contained blob: a header, a
+		 * table of pools, and the pools as they are laid out in memory.
+		 * The size of a blob is a multiple of 8, so blobs written one
+		 * after the other can be read back one after the other.
+		 *
+		 * The encoding is that of this platform and standard library:
+		 * the header records byte order and the size of every pool
+		 * entry, and read() refuses blobs that do not match.
+		 */
+		void write(std::string& out) const;
+
+		/*
+		 * A view of the blob at the start of bytes, which must be
+		 * aligned to 8 and stay alive as long as the view; nothing is
+		 * copied. Every handle is checked to be in range, but the blob
+		 * is not proven to be a tree, so only read what write() wrote.
+		 * On success the blob is removed from the front of bytes.
+		 */
+		static std::optional<FlatView> read(std::string_view& bytes);
+
+		/*
+		 * A tree equal to the one flattened, locations included, but
+		 * without file names. Nodes are allocated in arena when one is
+		 * given, which must then outlive the statement, and on the heap
+		 * otherwise.
+		 */
+		[[nodiscard]] Statement expand(Arena* arena = nullptr) const;
+
+		[[nodiscard]] const FlatOf<Statement>& root() const { return root_; }
+
+		/* All nodes of type T, in pre-order */
+		template <class T>
+		[[nodiscard]] std::span<const Flat<T>> nodes() const {
+			return std::get<flat_detail::NodeSpan<T>>(nodes_);
+		}
+
+		template <class T>
+		const Flat<T>& operator[](Ref<T> ref) const {
+			return nodes<T>()[ref.index];
+		}
+
+		template <class X>
+		std::span<const FlatOf<X>> operator[](Span<X> span) const {
+			return std::get<flat_detail::ElementSpan<X>>(spans_).subspan(span.offset, span.size);
+		}
+
+		std::string_view operator[](Text text) const {
+			return text_.substr(text.offset, text.size);
+		}
+
+		/* Number of nodes in the tree */
+		[[nodiscard]] std::size_t size() const;
+
+		/*
+		 * Pre-order traversal, the flat counterpart of default_visit.
+		 * For every node, visitor.enter(const Flat<X>&) is called if the
+		 * visitor accepts it; an enter() returning false skips the
+		 * node's children.
+		 */
+		template <class Visitor>
+		void walk(Visitor& visitor) const;
+	};
+
+	/*
+	 * Owns the pools of a flat tree. All reading goes through view(); the
+	 * accessors here are shorthands for it.
+	 */
+	class FlatTree {
+		flat_detail::Pools<flat_detail::NodeVector, FlatNodeTypes>::type nodes_;
+		flat_detail::Pools<flat_detail::ElementVector, FlatSpanTypes>::type spans_;
+		std::string text_;
+		FlatView view_;
+
+		friend struct flat_detail::Flattener;
+
+		template <class T>
+		std::vector<Flat<T>>& nodePool() { return std::get<flat_detail::NodeVector<T>>(nodes_); }
+
+		template <class X>
+		std::vector<FlatOf<X>>& spanPool() { return std::get<flat_detail::ElementVector<X>>(spans_); }
+
+		/* Point view_ at the pools again, after they changed or moved */
+		void refresh();
+
+	public:
+		FlatTree() = default;
+		explicit FlatTree(const Statement& stmt);
+
+		FlatTree(const FlatTree& other);
+		FlatTree(FlatTree&& other) noexcept;
+		FlatTree& operator=(const FlatTree& other);
+		FlatTree& operator=(FlatTree&& other) noexcept;
+
+		/*
+		 * Replace the tree by stmt. The pools keep their capacity, so a
+		 * FlatTree that is reused stops allocating once it has held the
+		 * largest statement.
+		 */
+		void assign(const Statement& stmt);
+		void clear();
+
+		[[nodiscard]] const FlatView& view() const { return view_; }
+
+		/* Bytes of node, span and text storage in use */
+		[[nodiscard]] std::size_t bytes() const;
+
+		void write(std::string& out) const { view_.write(out); }
+		[[nodiscard]] Statement expand(Arena* arena = nullptr) const { return view_.expand(arena); }
+		[[nodiscard]] const FlatOf<Statement>& root() const { return view_.root(); }
+		[[nodiscard]] std::size_t size() const { return view_.size(); }
+
+		template <class T>
+		[[nodiscard]] std::span<const Flat<T>> nodes() const { return view_.nodes<T>(); }
+
+		template <class H>
+		decltype(auto) operator[](H handle) const { return view_[handle]; }
+
+		template <class Visitor>
+		void walk(Visitor& visitor) const { view_.walk(visitor); }
+	};
+
+	namespace flat_detail {
+		/* Whether a flat value can lead to a node, so walks skip names, enums and text */
+		template <class F>
+		constexpr bool reachesNodes = false;
+
+		template <class T>
+		constexpr bool reachesNodes<Ref<T>> = true;
+
+		template <class X>
+		constexpr bool reachesNodes<Span<X>> = reachesNodes<FlatOf<X>>;
+
+		template <class... Fs>
+		constexpr bool reachesNodes<std::variant<Fs...>> = (reachesNodes<Fs> || ...);
+
+		template <class F>
+		constexpr bool reachesNodes<std::optional<F>> = reachesNodes<F>;
+
+		template <class A, class B>
+		constexpr bool reachesNodes<FlatPair<A, B>> = reachesNodes<A> || reachesNodes<B>;
+
+		template <class... Fs>
+		constexpr bool reachesNodes<Record<Fs...>> = (reachesNodes<Fs> || ...);
+
+		template <class S>
+		constexpr bool reachesNodes<Flat<S>> = reachesNodes<decltype(Flat<S>::members)>;
+
+		template <class Visitor>
+		struct Walker {
+			const FlatView& tree;
+			Visitor& visitor;
+
+			template <class T>
+			void descend(Ref<T> ref) {
+				if (!ref) {
+					return;
+				}
+				const Flat<T>& node = tree[ref];
+				if constexpr (requires { { visitor.enter(node) } -> std::same_as<bool>; }) {
+					if (!visitor.enter(node)) {
+						return;
+					}
+				} else if constexpr (requires { visitor.enter(node); }) {
+					visitor.enter(node);
+				}
+				descend(node);
+			}
+
+			template <class S>
+			void descend(const Flat<S>& flat) {
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					(descendIfReaching(field<I>(flat)), ...);
+				}(std::make_index_sequence<memberCount<S>>());
+			}
+
+			template <class F>
+			void descendIfReaching(const F& flat) {
+				if constexpr (reachesNodes<F>) {
+					descend(flat);
+				}
+			}
+
+			template <class X>
+			void descend(Span<X> span) {
+				if constexpr (reachesNodes<FlatOf<X>>) {
+					for (auto& element : tree[span]) {
+						descend(element);
+					}
+				}
+			}
+
+			template <class... Ts>
+			void descend(const std::variant<Ts...>& variant) {
+				std::visit([&](const auto& alternative) { descend(alternative); }, variant);
+			}
+
+			template <class X>
+			void descend(const std::optional<X>& optional) {
+				if (optional.has_value()) {
+					descend(*optional);
+				}
+			}
+
+			template <class A, class B>
+			void descend(const FlatPair<A, B>& pair) {
+				descend(pair.first);
+				descend(pair.second);
+			}
+
+			template <class X>
+			void descend(const X&) {}
+		};
+	}
+
+	template <class Visitor>
+	void FlatView::walk(Visitor& visitor) const {
+		flat_detail::Walker<Visitor> { *this, visitor }.descend(root_);
+	}
+}
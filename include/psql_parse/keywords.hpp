@@ -0,0 +1,329 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "parse.hpp"
+
+namespace psql_parse {
+
+	struct Keyword {
+		std::string_view text;
+		parser::token_kind_type token;
+	};
+
+	/*
+	 * Every reserved word the scanner knows, in lower case. A keyword
+	 * is one line here plus its %token in parse.y.
+	 */
+	inline constexpr Keyword keywords[] = {
+		{ "action",        parser::token::TOK_ACTION },
+		{ "all",           parser::token::TOK_ALL },
+		{ "and",           parser::token::TOK_AND },
+		{ "any",           parser::token::TOK_ANY },
+		{ "array",         parser::token::TOK_ARRAY },
+		{ "as",            parser::token::TOK_AS },
+		{ "asc",           parser::token::TOK_ASC },
+		{ "asymmetric",    parser::token::TOK_ASYMMETRIC },
+		{ "avg",           parser::token::TOK_AVG },
+		{ "between",       parser::token::TOK_BETWEEN },
+		{ "bigint",        parser::token::TOK_BIGINT },
+		{ "binary",        parser::token::TOK_BINARY },
+		{ "bit",           parser::token::TOK_BIT },
+		{ "blob",          parser::token::TOK_BLOB },
+		{ "boolean",       parser::token::TOK_BOOLEAN },
+		{ "by",            parser::token::TOK_BY },
+		{ "cascade",       parser::token::TOK_CASCADE },
+		{ "char",          parser::token::TOK_CHARACTER },
+		{ "character",     parser::token::TOK_CHARACTER },
+		{ "characters",    parser::token::TOK_CHARACTERS },
+		{ "clob",          parser::token::TOK_CLOB },
+		{ "collate",       parser::token::TOK_COLLATE },
+		{ "collect",       parser::token::TOK_COLLECT },
+		{ "commit",        parser::token::TOK_COMMIT },
+		{ "constraint",    parser::token::TOK_CONSTRAINT },
+		{ "count",         parser::token::TOK_COUNT },
+		{ "create",        parser::token::TOK_CREATE },
+		{ "cross",         parser::token::TOK_CROSS },
+		{ "cube",          parser::token::TOK_CUBE },
+		{ "current",       parser::token::TOK_CURRENT },
+		{ "current_user",  parser::token::TOK_CURRENT_USER },
+		{ "date",          parser::token::TOK_DATE },
+		{ "dec",           parser::token::TOK_DECIMAL },
+		{ "decimal",       parser::token::TOK_DECIMAL },
+		{ "default",       parser::token::TOK_DEFAULT },
+		{ "delete",        parser::token::TOK_DELETE },
+		{ "desc",          parser::token::TOK_DESC },
+		{ "distinct",      parser::token::TOK_DISTINCT },
+		{ "double",        parser::token::TOK_DOUBLE },
+		{ "escape",        parser::token::TOK_ESCAPE },
+		{ "every",         parser::token::TOK_EVERY },
+		{ "except",        parser::token::TOK_EXCEPT },
+		{ "exclude",       parser::token::TOK_EXCLUDE },
+		{ "exists",        parser::token::TOK_EXISTS },
+		{ "false",         parser::token::TOK_FALSE },
+		{ "fetch",         parser::token::TOK_FETCH },
+		{ "filter",        parser::token::TOK_FILTER },
+		{ "first",         parser::token::TOK_FIRST },
+		{ "float",         parser::token::TOK_FLOAT },
+		{ "following",     parser::token::TOK_FOLLOWING },
+		{ "foreign",       parser::token::TOK_FOREIGN },
+		{ "from",          parser::token::TOK_FROM },
+		{ "full",          parser::token::TOK_FULL },
+		{ "fusion",        parser::token::TOK_FUSION },
+		{ "global",        parser::token::TOK_GLOBAL },
+		{ "group",         parser::token::TOK_GROUP },
+		{ "grouping",      parser::token::TOK_GROUPING },
+		{ "groups",        parser::token::TOK_GROUPS },
+		{ "having",        parser::token::TOK_HAVING },
+		{ "in",            parser::token::TOK_IN },
+		{ "inner",         parser::token::TOK_INNER },
+		{ "insert",        parser::token::TOK_INSERT },
+		{ "int",           parser::token::TOK_INTEGER },
+		{ "integer",       parser::token::TOK_INTEGER },
+		{ "intersect",     parser::token::TOK_INTERSECT },
+		{ "intersection",  parser::token::TOK_INTERSECTION },
+		{ "into",          parser::token::TOK_INTO },
+		{ "is",            parser::token::TOK_IS },
+		{ "join",          parser::token::TOK_JOIN },
+		{ "key",           parser::token::TOK_KEY },
+		{ "large",         parser::token::TOK_LARGE },
+		{ "last",          parser::token::TOK_LAST },
+		{ "left",          parser::token::TOK_LEFT },
+		{ "like",          parser::token::TOK_LIKE },
+		{ "local",         parser::token::TOK_LOCAL },
+		{ "match",         parser::token::TOK_MATCH },
+		{ "max",           parser::token::TOK_MAX },
+		{ "min",           parser::token::TOK_MIN },
+		{ "multiset",      parser::token::TOK_MULTISET },
+		{ "national",      parser::token::TOK_NATIONAL },
+		{ "natural",       parser::token::TOK_NATURAL },
+		{ "nchar",         parser::token::TOK_NCHAR },
+		{ "nclob",         parser::token::TOK_NCLOB },
+		{ "next",          parser::token::TOK_NEXT },
+		{ "no",            parser::token::TOK_NO },
+		{ "not",           parser::token::TOK_NOT },
+		{ "null",          parser::token::TOK_NULL },
+		{ "nulls",         parser::token::TOK_NULLS },
+		{ "numeric",       parser::token::TOK_NUMERIC },
+		{ "object",        parser::token::TOK_OBJECT },
+		{ "octets",        parser::token::TOK_OCTETS },
+		{ "offset",        parser::token::TOK_OFFSET },
+		{ "on",            parser::token::TOK_ON },
+		{ "only",          parser::token::TOK_ONLY },
+		{ "or",            parser::token::TOK_OR },
+		{ "order",         parser::token::TOK_ORDER },
+		{ "others",        parser::token::TOK_OTHERS },
+		{ "outer",         parser::token::TOK_OUTER },
+		{ "partial",       parser::token::TOK_PARTIAL },
+		{ "partition",     parser::token::TOK_PARTITION },
+		{ "percent",       parser::token::TOK_PERCENT },
+		{ "preceding",     parser::token::TOK_PRECEDING },
+		{ "precision",     parser::token::TOK_PRECISION },
+		{ "preserve",      parser::token::TOK_PRESERVE },
+		{ "primary",       parser::token::TOK_PRIMARY },
+		{ "range",         parser::token::TOK_RANGE },
+		{ "real",          parser::token::TOK_REAL },
+		{ "recursive",     parser::token::TOK_RECURSIVE },
+		{ "ref",           parser::token::TOK_REF },
+		{ "references",    parser::token::TOK_REFERENCES },
+		{ "right",         parser::token::TOK_RIGHT },
+		{ "rollup",        parser::token::TOK_ROLLUP },
+		{ "row",           parser::token::TOK_ROW },
+		{ "rows",          parser::token::TOK_ROWS },
+		{ "scope",         parser::token::TOK_SCOPE },
+		{ "select",        parser::token::TOK_SELECT },
+		{ "session_user",  parser::token::TOK_SESSION_USER },
+		{ "set",           parser::token::TOK_SET },
+		{ "sets",          parser::token::TOK_SETS },
+		{ "smallint",      parser::token::TOK_SMALLINT },
+		{ "some",          parser::token::TOK_SOME },
+		{ "stddev_pop",    parser::token::TOK_STDDEV_POP },
+		{ "stddev_samp",   parser::token::TOK_STDDEV_SAMP },
+		{ "sum",           parser::token::TOK_SUM },
+		{ "symmetric",     parser::token::TOK_SYMMETRIC },
+		{ "system_user",   parser::token::TOK_SYSTEM_USER },
+		{ "table",         parser::token::TOK_TABLE },
+		{ "temporary",     parser::token::TOK_TEMPORARY },
+		{ "ties",          parser::token::TOK_TIES },
+		{ "time",          parser::token::TOK_TIME },
+		{ "timestamp",     parser::token::TOK_TIMESTAMP },
+		{ "true",          parser::token::TOK_TRUE },
+		{ "unbounded",     parser::token::TOK_UNBOUNDED },
+		{ "union",         parser::token::TOK_UNION },
+		{ "unique",        parser::token::TOK_UNIQUE },
+		{ "unknown",       parser::token::TOK_UNKNOWN },
+		{ "update",        parser::token::TOK_UPDATE },
+		{ "user",          parser::token::TOK_USER },
+		{ "using",         parser::token::TOK_USING },
+		{ "values",        parser::token::TOK_VALUES },
+		{ "var_pop",       parser::token::TOK_VAR_POP },
+		{ "var_samp",      parser::token::TOK_VAR_SAMP },
+		{ "varbinary",     parser::token::TOK_VARBINARY },
+		{ "varchar",       parser::token::TOK_VARCHAR },
+		{ "varying",       parser::token::TOK_VARYING },
+		{ "where",         parser::token::TOK_WHERE },
+		{ "window",        parser::token::TOK_WINDOW },
+		{ "with",          parser::token::TOK_WITH },
+		{ "without",       parser::token::TOK_WITHOUT },
+		{ "zone",          parser::token::TOK_ZONE },
+	};
+
+	/*
+	 * Perfect hash over the keywords, built by the compiler with the
+	 * hash-and-displace method: a word's hash picks a bucket, and the
+	 * bucket's seed remixes the same hash into a slot that no other
+	 * keyword uses. A lookup hashes the word once and compares it with
+	 * the one keyword that can match.
+	 */
+	template <std::size_t N>
+	class KeywordTable {
+		static constexpr std::size_t BUCKETS = std::bit_ceil(N / 2 + 1);
+		static constexpr std::size_t SLOTS = std::bit_ceil(N + N / 2);
+		static constexpr int SLOT_BITS = std::countr_zero(SLOTS);
+
+		// no keyword is longer, so every one fits in two registers
+		static constexpr std::size_t MAX_LENGTH = 16;
+
+		/* A word, zero padded into two integers of eight bytes each */
+		struct Packed {
+			std::uint64_t lo = 0;
+			std::uint64_t hi = 0;
+
+			constexpr bool operator==(const Packed&) const = default;
+		};
+
+		static constexpr Packed pack(std::string_view word) {
+			Packed packed;
+			for (std::size_t i = 0; i < word.size() && i < 8; i++) {
+				packed.lo |= static_cast<std::uint64_t>(static_cast<unsigned char>(word[i])) << (8 * i);
+			}
+			for (std::size_t i = 8; i < word.size(); i++) {
+				packed.hi |= static_cast<std::uint64_t>(static_cast<unsigned char>(word[i])) << (8 * (i - 8));
+			}
+			return packed;
+		}
+
+		// 'A' to 'Z' in all eight bytes at once to lower case, other bytes as they are
+		static constexpr std::uint64_t foldCase(std::uint64_t bytes) {
+			constexpr std::uint64_t ones = 0x0101010101010101;
+			auto low = bytes & (0x7f * ones);
+			// the top bit of each byte tells whether it is >= 'A', and > 'Z'
+			auto from_a = low + (0x80 - 'A') * ones;
+			auto after_z = low + (0x80 - 'Z' - 1) * ones;
+			auto upper = from_a & ~after_z & ~bytes & (0x80 * ones);
+			return bytes | (upper >> 2);
+		}
+
+		// two multiplies, independent of each other and of the length
+		static constexpr std::uint64_t hash(Packed word) {
+			std::uint64_t h = word.lo * 0x9e3779b97f4a7c15 ^ word.hi * 0xc2b2ae3d27d4eb4f;
+			return h ^ (h >> 32);
+		}
+
+		static constexpr std::uint64_t seedMix(std::uint64_t seed) {
+			return seed * 0x9e3779b97f4a7c15;
+		}
+
+		static constexpr std::size_t slot(std::uint64_t h, std::uint64_t mix) {
+			return static_cast<std::size_t>(((h ^ mix) * 0xff51afd7ed558ccd) >> (64 - SLOT_BITS));
+		}
+
+		// seedMix() of each bucket's seed
+		std::array<std::uint64_t, BUCKETS> mixes_ {};
+		// keyword index + 1, 0 for an empty slot
+		std::array<std::uint16_t, SLOTS> slots_ {};
+		std::size_t min_length_ = SIZE_MAX;
+		std::size_t max_length_ = 0;
+		// by keyword index + 1 as well; the empty slot holds a word no lookup can match
+		std::array<Packed, N + 1> packed_ {};
+		std::array<parser::token_kind_type, N + 1> tokens_ {};
+
+		/*
+		 * The comparison is the only branch, whichever slot the word
+		 * hashes to.
+		 */
+		[[nodiscard]] constexpr std::optional<parser::token_kind_type> find(Packed word) const {
+			auto h = hash(word);
+			auto index = slots_[slot(h, mixes_[h & (BUCKETS - 1)])];
+			if (packed_[index] != word) {
+				return std::nullopt;
+			}
+			return tokens_[index];
+		}
+
+	public:
+		explicit consteval KeywordTable(const Keyword (&keywords)[N]) {
+			packed_[0] = Packed { ~std::uint64_t(0), ~std::uint64_t(0) };
+			std::array<std::size_t, N> bucket_of {};
+			std::array<std::size_t, BUCKETS> bucket_size {};
+			for (std::size_t i = 0; i < N; i++) {
+				if (keywords[i].text.size() > MAX_LENGTH) {
+					throw "keyword longer than MAX_LENGTH";
+				}
+				packed_[i + 1] = pack(keywords[i].text);
+				tokens_[i + 1] = keywords[i].token;
+				bucket_of[i] = hash(packed_[i + 1]) & (BUCKETS - 1);
+				bucket_size[bucket_of[i]]++;
+				min_length_ = std::min(min_length_, keywords[i].text.size());
+				max_length_ = std::max(max_length_, keywords[i].text.size());
+			}
+
+			// place the largest buckets first, while there is still room
+			std::array<std::size_t, BUCKETS> order {};
+			for (std::size_t b = 0; b < BUCKETS; b++) {
+				order[b] = b;
+			}
+			std::sort(order.begin(), order.end(), [&](std::size_t l, std::size_t r) {
+				return bucket_size[l] > bucket_size[r];
+			});
+
+			for (std::size_t bucket : order) {
+				if (bucket_size[bucket] == 0) {
+					break;
+				}
+				for (std::uint64_t seed = 1;; seed++) {
+					std::array<std::uint16_t, SLOTS> tried = slots_;
+					bool fits = true;
+					for (std::size_t i = 0; i < N && fits; i++) {
+						if (bucket_of[i] != bucket) {
+							continue;
+						}
+						auto s = slot(hash(packed_[i + 1]), seedMix(seed));
+						fits = tried[s] == 0;
+						tried[s] = static_cast<std::uint16_t>(i + 1);
+					}
+					if (fits) {
+						mixes_[bucket] = seedMix(seed);
+						slots_ = tried;
+						break;
+					}
+				}
+			}
+		}
+
+		/* word must already be lower case */
+		[[nodiscard]] constexpr std::optional<parser::token_kind_type> find(std::string_view word) const {
+			if (word.size() < min_length_ || word.size() > max_length_) {
+				return std::nullopt;
+			}
+			return find(pack(word));
+		}
+
+		/* word in any case, which saves copying it to lower case first */
+		[[nodiscard]] constexpr std::optional<parser::token_kind_type> findIgnoringCase(std::string_view word) const {
+			if (word.size() < min_length_ || word.size() > max_length_) {
+				return std::nullopt;
+			}
+			auto packed = pack(word);
+			return find(Packed { foldCase(packed.lo), foldCase(packed.hi) });
+		}
+	};
+
+	inline constexpr KeywordTable keyword_table(keywords);
+}
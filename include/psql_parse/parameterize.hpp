@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "psql_parse/arena.hpp"
+#include "psql_parse/ast/stmt.hpp"
+
+namespace psql_parse {
+
+	struct Parameterized {
+		Statement statement;
+
+		/* Highest $n the statement already held before, usually 0 */
+		std::uint64_t existing;
+
+		/* constants[i] is the literal $(existing + i + 1) stands for */
+		std::vector<Literal> constants;
+	};
+
+	/*
+	 * Replace every integer, float, string and boolean literal in an
+	 * expression position by a Param, in a single pass and in the order
+	 * the literals appear in the text. The literal nodes themselves are
+	 * moved into constants, locations included, so nothing is rendered
+	 * or copied.
+	 *
+	 * Literals the tree only holds as syntax stay where they are: the
+	 * truth value of IS [NOT] TRUE, the counts of OFFSET and FETCH, and
+	 * the parts of CREATE TABLE. Params already in the statement keep
+	 * their numbers; the new ones are numbered after them, as
+	 * pg_stat_statements does.
+	 *
+	 * The Param nodes are allocated in arena when one is given, which
+	 * must then outlive the statement, and on the heap otherwise.
+	 */
+	Parameterized parameterize(Statement stmt, Arena* arena = nullptr);
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <optional>
+#include <string_view>
+
 #include "parse.hpp"
 
 #ifndef __FLEX_LEXER_H
@@ -18,14 +22,50 @@ namespace psql_parse {
 
     class scanner : public yyFlexLexer {
         psql_parse::location loc;
+        // bytes of input matched so far
+        std::size_t offset_ = 0;
 
 		/* STATE while lexing string literals */
 		std::string string_buffer;
 		std::string ident_buffer;
+		std::string lower_buffer;
+
+		/*
+		 * Recently seen identifiers, indexed by hash. Most names repeat,
+		 * so this keeps the shared symbol table (and its lock) out of the
+		 * common case when several scanners run in parallel.
+		 */
+		std::array<Name, 256> symbol_cache_;
 		StringLiteralType string_type;
 
+		/* Remaining caller memory when scanning a buffer instead of yyin */
+		std::optional<std::string_view> input_;
+
 		void start_string(StringLiteralType type);
 		void start_ident();
+		/* A keyword token, or else an interned, lower-cased IDENTIFIER */
+		psql_parse::parser::symbol_type identifier(const char *text, std::size_t length);
+
+		/*
+		 * For the vector fast paths in actions: the input flex has read
+		 * but not matched yet, and matching length more bytes of it
+		 * without going through the DFA. After unmatched(), yytext is no
+		 * longer NUL terminated.
+		 */
+		std::string_view unmatched();
+		void advance(std::size_t length);
+
+		/*
+		 * Append the rest of a quoted literal to buffer, quote doubled
+		 * standing for itself if doubled is set. True once the closing
+		 * quote has been consumed, false if flex has to read more input
+		 * first; scanning then continues in the current start condition.
+		 */
+		bool scan_quoted(std::string &buffer, char quote, bool doubled);
+		psql_parse::parser::symbol_type string_token();
+
+    protected:
+        int LexerInput(char *buf, int max_size) override;
 
     public:
         explicit scanner(std::istream *in = nullptr, std::ostream *out = nullptr);
@@ -33,6 +73,29 @@ namespace psql_parse {
         virtual psql_parse::parser::symbol_type lex();
 
         void reset();
+
+        /*
+         * Restart the scanner on new input. The flex buffer is kept, so
+         * switching inputs does not allocate. A string_view is read in
+         * place and must outlive the scan.
+         */
+        void reset(std::istream &in);
+        void reset(std::string_view input);
+
+        /* Bytes of input up to the end of the last token */
+        [[nodiscard]] std::size_t offset() const { return offset_; }
+
+        /*
+         * Locations of the tokens that follow are counted from the end of
+         * the last one, as if the input started there
+         */
+        void restartLocation() { loc = location(); }
+
+        /* Capacity of the buffers for literals and names */
+        [[nodiscard]] std::size_t bytesReserved() const;
+
+        /* Free the buffers that have grown beyond bytes */
+        void trim(std::size_t bytes);
     };
 
 }
\ No newline at end of file
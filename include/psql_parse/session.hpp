@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "psql_parse/driver.hpp"
+
+namespace psql_parse {
+
+	/*
+	 * Parses one statement after another on a single thread, reusing the
+	 * parser stack, the scanner buffers and an arena for the nodes from
+	 * one parse to the next. Once warmed up on statements of a given
+	 * size, a parse does not allocate at all (string literals longer than
+	 * the standard library keeps inline excepted).
+	 *
+	 * Memory kept above high_water bytes after an unusually large input
+	 * is given back before the next parse.
+	 *
+	 * Syntax errors are not printed, they are in diagnostics().
+	 */
+	class ParseSession {
+		driver driver_;
+		std::size_t high_water_;
+
+	public:
+		static constexpr std::size_t DEFAULT_HIGH_WATER = 1024 * 1024;
+
+		explicit ParseSession(std::size_t high_water = DEFAULT_HIGH_WATER);
+
+		ParseSession(const ParseSession&) = delete;
+		ParseSession& operator=(const ParseSession&) = delete;
+
+		/*
+		 * The statement, or nullptr if the input is not exactly one valid
+		 * statement. Valid until the next call.
+		 */
+		const Statement* parse(std::string_view input);
+
+		[[nodiscard]] const std::vector<Diagnostic>& diagnostics() const { return driver_.diagnostics(); }
+
+		/* Bytes kept for the next parse */
+		[[nodiscard]] std::size_t bytesReserved() const { return driver_.bytesReserved(); }
+	};
+}
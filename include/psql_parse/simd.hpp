@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace psql_parse::simd {
+
+	/*
+	 * Vector kernels for the scanner's longest loops. The implementation
+	 * is picked once, on first use, from what the CPU supports: AVX2,
+	 * SSE2 or plain C++.
+	 */
+
+	/* Length of the prefix of text made of ' ', '\t', '\r' and '\f' */
+	std::size_t blankRun(std::string_view text);
+
+	/* Position of the first quote in text, text.size() if there is none */
+	std::size_t findQuote(std::string_view text, char quote);
+
+	/* "avx2", "sse2" or "scalar" */
+	const char* kernel();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "psql_parse/ast/stmt.hpp"
+
+namespace psql_parse {
+
+	/*
+	 * What one parse (a statement, or a whole script) cost. Only counted
+	 * in builds with PSQL_PARSE_STATS defined (the CMake option of the
+	 * same name); otherwise the counting compiles away and every field
+	 * stays zero.
+	 */
+	struct ParseStats {
+#ifdef PSQL_PARSE_STATS
+		static constexpr bool enabled = true;
+#else
+		static constexpr bool enabled = false;
+#endif
+
+		std::uint64_t tokens = 0;
+
+		/* Nodes created, by their position in NodeTypes */
+		std::array<std::uint64_t, nodeTypeCount> nodes {};
+
+		/* sizeof of every node created, and arena memory handed out */
+		std::uint64_t node_bytes = 0;
+		std::uint64_t arena_bytes = 0;
+
+		/* The deepest the parser's stack was when a token was read */
+		std::uint64_t max_stack_depth = 0;
+
+		/*
+		 * Wall time of the whole parse, and the part of it spent in the
+		 * scanner. The scanner is only timed on every 64th token and the
+		 * total extrapolated from that, to keep the clock off the hot
+		 * path; the rest is the parser's.
+		 */
+		std::uint64_t total_ns = 0;
+		std::uint64_t scan_ns = 0;
+
+		void add(const ParseStats& other);
+	};
+
+	/* The name of the node type at index in NodeTypes */
+	const char* nodeTypeName(std::size_t index);
+
+	/*
+	 * Sums the stats of every parse of the drivers it is attached to (see
+	 * driver::collectStats), from any number of threads, for a monitor
+	 * to read every now and then.
+	 */
+	class StatsCollector {
+	public:
+		struct Snapshot {
+			std::uint64_t parses;
+			/* Summed over all parses, except for the deepest stack */
+			ParseStats totals;
+		};
+
+		void add(const ParseStats& stats);
+
+		[[nodiscard]] Snapshot snapshot() const;
+
+		/* The snapshot, and start counting from zero again */
+		Snapshot take();
+
+	private:
+		mutable std::mutex mutex_;
+		Snapshot current_ {};
+	};
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "psql_parse/arena.hpp"
+
+namespace psql_parse {
+
+	class SymbolTable;
+
+	/*
+	 * Handle to an interned identifier.
+	 *
+	 * All symbols are interned in SymbolTable::global(), so two symbols
+	 * with the same text share one entry: equality is a pointer compare
+	 * and the hash is computed once, when the text is first interned.
+	 * Ordering is by text, so sorted output does not depend on the order
+	 * in which names were first seen.
+	 */
+	class Symbol {
+	public:
+		struct Entry {
+			std::size_t hash;
+			std::size_t length;
+			const char* data;
+		};
+
+	private:
+		const Entry* entry_;
+
+		static const Entry empty_;
+
+		explicit Symbol(const Entry* entry)
+		: entry_(entry) {}
+
+		friend class SymbolTable;
+
+	public:
+		Symbol()
+		: entry_(&empty_) {}
+
+		Symbol(std::string_view text);
+
+		Symbol(const std::string& text)
+		: Symbol(std::string_view(text)) {}
+
+		Symbol(const char* text)
+		: Symbol(std::string_view(text)) {}
+
+		[[nodiscard]] std::string_view str() const { return { entry_->data, entry_->length }; }
+
+		[[nodiscard]] std::size_t hash() const { return entry_->hash; }
+
+		[[nodiscard]] bool empty() const { return entry_->length == 0; }
+
+		friend bool operator==(const Symbol& l, const Symbol& r) noexcept {
+			return l.entry_ == r.entry_;
+		}
+
+		friend std::strong_ordering operator<=>(const Symbol& l, const Symbol& r) noexcept {
+			if (l.entry_ == r.entry_) {
+				return std::strong_ordering::equal;
+			}
+			return l.str() <=> r.str();
+		}
+
+		friend std::ostream& operator<<(std::ostream& out, const Symbol& symbol) {
+			return out << symbol.str();
+		}
+	};
+
+	/*
+	 * Thread-safe interning table. Lookups of names that are already
+	 * known only take a shared lock; entries are never removed, their
+	 * text is kept in an arena owned by the table.
+	 */
+	class SymbolTable {
+		mutable std::shared_mutex mutex_;
+		std::unordered_map<std::string_view, const Symbol::Entry*> entries_;
+		Arena storage_;
+
+	public:
+		SymbolTable() = default;
+
+		SymbolTable(const SymbolTable&) = delete;
+		SymbolTable& operator=(const SymbolTable&) = delete;
+
+		Symbol intern(std::string_view text);
+
+		[[nodiscard]] std::size_t size() const;
+
+		/* The table used by Symbol's constructors */
+		static SymbolTable& global();
+	};
+}
+
+template <>
+struct std::hash<psql_parse::Symbol> {
+	std::size_t operator()(const psql_parse::Symbol& symbol) const noexcept {
+		return symbol.hash();
+	}
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "parse.hpp"
+
+namespace psql_parse {
+
+	/*
+	 * A token as the scanner would read it, but without its value: names
+	 * and literals are left in the source, see text(). The kind is the
+	 * parser's, so every keyword has its own. A byte that starts no token
+	 * is a YYUNDEF token, and so is a quoted literal or name still open
+	 * at the end of the source.
+	 */
+	struct Token {
+		std::uint32_t offset;
+		std::uint32_t length;
+		parser::symbol_kind_type kind;
+
+		/* The whole lexeme; quotes and the prefix of literals included */
+		[[nodiscard]] std::string_view text(std::string_view source) const {
+			return source.substr(offset, length);
+		}
+	};
+
+	/*
+	 * Append the tokens of source to tokens, for what needs no tree:
+	 * highlighting, splitting at ';', telling statements apart by their
+	 * first keyword. Nothing is copied, converted or interned, which
+	 * makes this many times faster than the parser's scanner; a vector
+	 * reused from call to call stops allocating as well. The source has
+	 * to be smaller than 4 GiB.
+	 */
+	void tokenize(std::string_view source, std::vector<Token>& tokens);
+	std::vector<Token> tokenize(std::string_view source);
+}
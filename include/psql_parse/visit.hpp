@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <ostream>
 #include <variant>
+#include <vector>
 
 #include "psql_parse/ast/create.hpp"
 #include "psql_parse/ast/select.hpp"
@@ -9,248 +12,437 @@
 
 namespace psql_parse {
 
+    /* Writes the SQL of deparse() to a stream */
     struct printer {
         std::ostream& out;
-        struct rel_expr_visitor {
-            printer& context;
-            void operator()(box<JoinExpr>&);
-            void operator()(box<TableName>&);
-            void operator()(box<TableAlias>&);
-            void operator()(box<SelectExpr>&);
-            void operator()(box<ValuesExpr>&);
-            void operator()(box<SetOp>&);
-            void operator()(box<Query>&);
-        };
 
-        struct expr_visitor {
-            printer& context;
-            void operator()(box<AliasExpr> &expr);
-            void operator()(box<Asterisk> &expr);
-            void operator()(box<IntegerLiteral> &expr);
-            void operator()(box<FloatLiteral> &expr);
-            void operator()(box<StringLiteral> &expr);
-            void operator()(box<BooleanLiteral> &expr);
-            void operator()(box<UnaryOp> &expr);
-            void operator()(box<BinaryOp> &expr);
-            void operator()(box<RowExpr> &expr);
-            void operator()(box<RowSubquery> &expr);
-            void operator()(box<Var> &expr);
-            void operator()(box<Collate> &expr);
-            void operator()(box<IsExpr> &expr);
-            void operator()(box<BetweenPred> &expr);
-            void operator()(box<InPred> &expr);
-            void operator()(box<LikePred> &expr);
-            void operator()(box<ExistsPred> &expr);
-            void operator()(box<UniquePred> &expr);
-            void operator()(box<SortSpec> &expr);
-            void operator()(box<GroupingSet> &expr);
-            void operator()(box<GroupingSets> &expr);
-            void operator()(box<Rollup> &expr);
-            void operator()(box<Cube> &expr);
-            void operator()(box<AggregateExpr> &expr);
-        };
+        explicit printer(std::ostream &out)
+        : out(out) {};
+
+        void print(const Expression& expr);
+        void print(const RelExpression& expr);
+        void print(const Statement& stmt);
+    };
+
+
+    /*
+     * Runs the steps of a tree walk on an explicit stack once the walk
+     * gets deep, so a tree of any depth is walked in bounded native
+     * stack. A step is a function and the node it runs on.
+     *
+     * call() runs a step directly while the walk has used less than
+     * STACK_BUDGET bytes of native stack, which keeps ordinary trees as
+     * fast as plain recursion. Past that, or once anything is queued, it
+     * queues the step instead: steps queued while a step runs go on top
+     * of the stack in the order they were queued, and all of them finish
+     * before the steps below them, so the order of the walk is the same
+     * either way.
+     *
+     * run() drains the stack; calling it again from inside a step only
+     * queues, the outer run() picks up whatever was queued.
+     */
+    template <class Context, class Data = void>
+    class work_stack {
+    public:
+        using step = void (*)(Context&, Data*);
+
+        static constexpr std::uintptr_t STACK_BUDGET = 32 * 1024;
+
+        template <step Fn>
+        void call(Context& context, Data* node) {
+            // the stack grows down; anywhere else every step is queued
+            char here;
+            if (reinterpret_cast<std::uintptr_t>(&here) > limit_) [[likely]] {
+                Fn(context, node);
+            } else {
+                later(Fn, node);
+            }
+        }
+
+        // kept out of line, call() sits on every edge of the tree
+        [[gnu::noinline]] void later(step fn, Data* node) {
+            // nothing runs directly any more until the queue is flushed
+            limit_ = BLOCKED;
+            queued_.push_back({fn, node});
+        }
+
+        /* Nothing has been queued by the step that is running */
+        [[nodiscard]] bool idle() const {
+            return queued_.empty();
+        }
+
+        void run(Context& context) {
+            if (running_)
+                return;
+
+            start();
+            try {
+                drain(context);
+            } catch (...) {
+                reset();
+                throw;
+            }
+            reset();
+        }
+
+        /* Walk from node: run fn on it and then drain the stack */
+        void run(Context& context, step fn, Data* node) {
+            if (running_) {
+                later(fn, node);
+                return;
+            }
+
+            start();
+            try {
+                fn(context, node);
+                drain(context);
+            } catch (...) {
+                reset();
+                throw;
+            }
+            reset();
+        }
 
-        struct stmt_visitor {
-            printer& context;
-            void operator()(box<CreateStatement> &stmt);
-            void operator()(box<InsertStatement> &stmt);
-            void operator()(box<DeleteStatement> &stmt);
-            void operator()(box<SelectStatement> &stmt);
+    private:
+        struct frame {
+            step fn;
+            Data* node;
         };
 
-        rel_expr_visitor rev;
-        expr_visitor ev;
-        stmt_visitor sv;
+        static constexpr std::uintptr_t BLOCKED = UINTPTR_MAX;
 
-        explicit printer(std::ostream &out)
-        : out(out), rev {*this}, ev {*this}, sv{*this} {};
-
-        void print(Expression& expr);
-        void print(RelExpression& expr);
-        void print(Statement& stmt);
-        void print(SetQuantifier q);
-        void print(JoinExpr::Kind q);
-        void print(QualifiedName& q);
-        void print(BooleanLiteral::Val v);
+        void start() {
+            char here;
+            auto top = reinterpret_cast<std::uintptr_t>(&here);
+            stack_limit_ = top > STACK_BUDGET ? top - STACK_BUDGET : 0;
+            limit_ = stack_limit_;
+            running_ = true;
+        }
+
+        void drain(Context& context) {
+            flush();
+            while (!frames_.empty()) {
+                auto frame = frames_.back();
+                frames_.pop_back();
+                frame.fn(context, frame.node);
+                flush();
+            }
+        }
+
+        void flush() {
+            frames_.insert(frames_.end(), queued_.rbegin(), queued_.rend());
+            queued_.clear();
+            limit_ = stack_limit_;
+        }
+
+        void reset() {
+            frames_.clear();
+            queued_.clear();
+            limit_ = BLOCKED;
+            running_ = false;
+        }
+
+        std::vector<frame> frames_;
+        std::vector<frame> queued_;
+        std::uintptr_t stack_limit_ = 0;
+        std::uintptr_t limit_ = BLOCKED;
+        bool running_ = false;
     };
 
 
+    /*
+     * Traversal of every node reachable from an expression or statement,
+     * for visitors that only care about some of the nodes. It keeps its
+     * own stack once it gets deep, so it is safe on trees of any depth,
+     * such as the left deep BinaryOp chain of a long OR.
+     *
+     * T is the visitor; default_visit<T> calls, when T declares them:
+     *   T::enter(box<X>&)       once for each node, before its children
+     *   T::leave(box<X>&)       once for each node, after its children
+     *   T::visit(Expression&)   instead of descending into the expression
+     *   T::visit(RelExpression&)
+     *   T::visit(Statement&)
+     * A T::visit overload decides itself whether to descend(), so it can
+     * skip or replace subtrees. Deep in a tree, descend() only queues the
+     * children and they are visited after the hook returns, so whatever
+     * has to happen after them belongs in leave().
+     */
     template <typename T>
     struct default_visit {
-        struct rel_expr_visitor {
-            default_visit& context;
-            void operator()(box<JoinExpr>& expr) {
-                context.visit(expr->first);
-                context.visit(expr->second);
+        T& derived;
 
-                if (expr->qualifier.has_value())
-                    context.visit(expr->qualifier.value());
+        explicit default_visit(T& derived)
+        : derived(derived) {}
 
-                for (auto &col : expr->columns)
-                    context.visit(col);
-            }
+        void visit(RelExpression& expr) {
+            work.run(*this, &step<RelExpression>, &expr);
+        }
+        void visit(Expression& expr) {
+            work.run(*this, &step<Expression>, &expr);
+        }
+        void visit(Statement& stmt) {
+            work.run(*this, &step<Statement>, &stmt);
+        }
+        void visit(Grouping& grouping) {
+            work.run(*this, &step<Grouping>, &grouping);
+        }
 
-            void operator()(box<TableName>&) {}
+        void descend(RelExpression& expr) {
+            std::visit([this](auto& node) { expand(node); }, expr);
+            work.run(*this);
+        }
+        void descend(Expression& expr) {
+            std::visit([this](auto& node) { expand(node); }, expr);
+            work.run(*this);
+        }
+        void descend(Statement& stmt) {
+            std::visit([this](auto& node) { expand(node); }, stmt);
+            work.run(*this);
+        }
 
-            void operator()(box<TableAlias>&expr) {
-                context.visit(expr->expression);
-            }
+    private:
+        work_stack<default_visit> work;
 
-            void operator()(box<SelectExpr>& expr) {
-                for (auto &target : expr->target_list)
-                    context.visit(target);
+        template <class V>
+        static void step(default_visit& self, void* node) {
+            auto& value = *static_cast<V*>(node);
+            if constexpr (requires { self.derived.visit(value); })
+                self.derived.visit(value);
+            else
+                std::visit([&self](auto& n) { self.expand(n); }, value);
+        }
 
-                for (auto &from : expr->from_clause)
-                    context.visit(from);
+        template <class N>
+        static void stepNode(default_visit& self, void* node) {
+            self.expand(*static_cast<box<N>*>(node));
+        }
 
-                if (expr->where_clause.has_value())
-                    context.visit(expr->where_clause.value());
+        template <class N>
+        static void stepLeave(default_visit& self, void* node) {
+            self.derived.leave(*static_cast<box<N>*>(node));
+        }
 
-                if (expr->group_clause.has_value())
-                    for (auto &group : expr->group_clause->group_clause)
-                        context.visit(group);
+        void child(Expression& expr) { work.template call<&step<Expression>>(*this, &expr); }
+        void child(RelExpression& expr) { work.template call<&step<RelExpression>>(*this, &expr); }
 
-                if (expr->having_clause.has_value())
-                    context.visit(expr->having_clause.value());
-            }
+        void child(Grouping& grouping) {
+            std::visit([this](auto& node) { child(node); }, grouping);
+        }
 
-            void operator()(box<ValuesExpr> &expr) {
-                for (auto &row : expr->rows)
-                    context.visit(row);
-            }
+        template <class N>
+        void child(box<N>& node) {
+            work.template call<&stepNode<N>>(*this, &node);
+        }
 
-            void operator()(box<SetOp>& expr) {
-                context.visit(expr->left);
-                context.visit(expr->right);
-            }
+        template <class N>
+        void expand(box<N>& node) {
+            if constexpr (requires { derived.enter(node); })
+                derived.enter(node);
 
-            void operator()(box<Query>& expr) {
-                context.visit(expr->expr);
+            children(node);
 
-                if (expr->with.has_value())
-                    for (auto &with : expr->with.value()->elements)
-                        context.visit(with->query);
+            if constexpr (requires { derived.leave(node); })
+                work.template call<&stepLeave<N>>(*this, &node);
+        }
 
-                for (auto &sort : expr->order)
-                    context.visit(sort);
+        // literals, names and CREATE TABLE have no nodes below them
+        template <class N>
+        void children(box<N>&) {}
 
-                if (expr->offset.has_value())
-                    context.visit(expr->offset.value());
+        /*
+         * Statements
+         */
 
-                if (expr->fetch.has_value())
-                    context.visit(expr->fetch.value());
-            }
-        };
+        void children(box<InsertStatement>& stmt) {
+            if (auto query = std::get_if<box<Query>>(&stmt->source))
+                child(*query);
+        }
 
-        struct expr_visitor {
-            default_visit& context;
-            void operator()(box<AliasExpr> &expr) {
-                context.visit(expr->expr);
-            };
-            void operator()(box<Asterisk> &) {};
-            void operator()(box<IntegerLiteral> &) {};
-            void operator()(box<FloatLiteral> &) {};
-            void operator()(box<StringLiteral> &) {};
-            void operator()(box<BooleanLiteral> &) {};
-            void operator()(box<UnaryOp> &expr) {
-                context.visit(expr->inner);
-            };
-            void operator()(box<BinaryOp> &expr) {
-                context.visit(expr->left);
-                context.visit(expr->right);
-            };
-            void operator()(box<RowExpr> &expr) {
-                for (auto &ex : expr->exprs)
-                    context.visit(ex);
-            };
-            void operator()(box<RowSubquery> &expr) {
-                context.visit(expr->subquery);
-            };
-            void operator()(box<Var> &expr) {
-
-            };
-            void operator()(box<Collate> &expr) {
-                context.visit(expr->var);
-            };
-            void operator()(box<IsExpr> &expr) {
-                context.visit(expr->inner);
-            };
-            void operator()(box<BetweenPred> &expr) {
-                context.visit(expr->val);
-                context.visit(expr->low);
-                context.visit(expr->high);
-            };
-            void operator()(box<InPred> &expr) {
-                context.visit(expr->val);
-                context.visit(expr->rows);
-            };
-            void operator()(box<LikePred> &expr) {
-                context.visit(expr->val);
-                context.visit(expr->pattern);
-                context.visit(expr->escape);
-            };
-            void operator()(box<ExistsPred> &expr) {
-                context.visit(expr->subquery);
-            };
-            void operator()(box<UniquePred> &expr) {
-                context.visit(expr->subquery);
-            };
-            void operator()(box<SortSpec> &expr) {
-                context.visit(expr->expr);
-            };
-            void operator()(box<GroupingSet> &expr) {
-                for (auto &ex : expr->columns)
-                    context.visit(ex);
-            };
-            void operator()(box<GroupingSets> &expr) {
-                for (auto &ex : expr->sets)
-                    context.visit(ex);
-            };
-            void operator()(box<Rollup> &expr) {
-                for (auto &ex : expr->sets)
-                    context.visit(ex);
-            };
-            void operator()(box<Cube> &expr) {
-                for (auto &ex : expr->sets)
-                    context.visit(ex);
-            };
-            void operator()(box<AggregateExpr> &expr) {
-                context.visit(expr->argument);
-
-                if (expr->filter.has_value())
-                    context.visit(expr->filter.value());
-            };
-        };
+        void children(box<DeleteStatement>& stmt) {
+            if (stmt->where.has_value())
+                child(stmt->where.value());
+        }
 
-        struct stmt_visitor {
-            default_visit& context;
-            void operator()(box<CreateStatement> &stmt){};
-            void operator()(box<InsertStatement> &stmt){
-                auto &src = stmt->source;
-                if (std::holds_alternative<box<Query>>(src)) {
-                    context.rev(std::get<box<Query>>(src));
-                }
-            };
-            void operator()(box<DeleteStatement> &stmt){
-                if (stmt->where.has_value()) {
-                    context.ev(stmt->where.value());
-                }
-            };
-            void operator()(box<SelectStatement> &stmt){
-                context.rev(stmt->rel_expr);
-            };
-        };
+        void children(box<SelectStatement>& stmt) {
+            child(stmt->rel_expr);
+        }
 
-        T& derived;
+        /*
+         * Query expressions
+         */
 
-        void visit(RelExpression& expr) {
-            derived.visit(expr);
+        void children(box<JoinExpr>& expr) {
+            child(expr->first);
+            child(expr->second);
+
+            if (expr->qualifier.has_value())
+                child(expr->qualifier.value());
         }
-        void visit(Expression& expr) {
-            derived.visit(expr);
+
+        void children(box<TableAlias>& expr) {
+            child(expr->expression);
+        }
+
+        void children(box<SelectExpr>& expr) {
+            for (auto& target : expr->target_list)
+                child(target);
+
+            for (auto& from : expr->from_clause)
+                child(from);
+
+            if (expr->where_clause.has_value())
+                child(expr->where_clause.value());
+
+            if (expr->group_clause.has_value())
+                for (auto& group : expr->group_clause->group_clause)
+                    child(group);
+
+            if (expr->having_clause.has_value())
+                child(expr->having_clause.value());
+
+            for (auto& window : expr->window_clause)
+                child(window);
+        }
+
+        void children(box<ValuesExpr>& expr) {
+            for (auto& row : expr->rows)
+                child(row);
+        }
+
+        void children(box<SetOp>& expr) {
+            child(expr->left);
+            child(expr->right);
+        }
+
+        void children(box<Query>& expr) {
+            if (expr->with.has_value())
+                child(expr->with.value());
+
+            child(expr->expr);
+
+            for (auto& sort : expr->order)
+                child(sort);
+
+            if (expr->offset.has_value())
+                child(expr->offset.value());
+
+            if (expr->fetch.has_value() && expr->fetch->value.has_value())
+                child(expr->fetch->value.value());
+        }
+
+        void children(box<WithClause>& with) {
+            for (auto& spec : with->elements)
+                child(spec);
+        }
+
+        void children(box<WithSpec>& spec) {
+            child(spec->query);
+        }
+
+        /*
+         * Value expressions
+         */
+
+        void children(box<AliasExpr>& expr) {
+            child(expr->expr);
+        }
+
+        void children(box<UnaryOp>& expr) {
+            child(expr->inner);
+        }
+
+        void children(box<BinaryOp>& expr) {
+            child(expr->left);
+            child(expr->right);
+        }
+
+        void children(box<RowExpr>& expr) {
+            for (auto& ex : expr->exprs)
+                child(ex);
+        }
+
+        void children(box<RowSubquery>& expr) {
+            child(expr->subquery);
+        }
+
+        void children(box<Collate>& expr) {
+            child(expr->var);
+        }
+
+        void children(box<IsExpr>& expr) {
+            child(expr->inner);
+            child(expr->truth_value);
+        }
+
+        void children(box<BetweenPred>& expr) {
+            child(expr->val);
+            child(expr->low);
+            child(expr->high);
+        }
+
+        void children(box<InPred>& expr) {
+            child(expr->val);
+            child(expr->rows);
+        }
+
+        void children(box<LikePred>& expr) {
+            child(expr->val);
+            child(expr->pattern);
+            if (expr->escape.has_value())
+                child(expr->escape.value());
+        }
+
+        void children(box<ExistsPred>& expr) {
+            child(expr->subquery);
+        }
+
+        void children(box<UniquePred>& expr) {
+            child(expr->subquery);
+        }
+
+        void children(box<SortSpec>& expr) {
+            child(expr->expr);
+        }
+
+        void children(box<GroupingSet>& expr) {
+            for (auto& ex : expr->columns)
+                child(ex);
+        }
+
+        void children(box<GroupingSets>& expr) {
+            for (auto& ex : expr->sets)
+                child(ex);
+        }
+
+        void children(box<Rollup>& expr) {
+            for (auto& ex : expr->sets)
+                child(ex);
+        }
+
+        void children(box<Cube>& expr) {
+            for (auto& ex : expr->sets)
+                child(ex);
+        }
+
+        void children(box<AggregateExpr>& expr) {
+            child(expr->argument);
+
+            if (expr->filter.has_value())
+                child(expr->filter.value());
         }
-        void visit(Statement & stmt) {
-            derived.visit(stmt);
+
+        void children(box<Window>& expr) {
+            for (auto& ex : expr->partition)
+                child(ex);
+
+            for (auto& sort : expr->sort)
+                child(sort);
+
+            if (expr->frame.has_value()) {
+                child(expr->frame->start.second);
+                if (expr->frame->end.has_value())
+                    child(expr->frame->end->second);
+            }
         }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,87 @@
+#include <cstdlib>
+
+#include "psql_parse/arena.hpp"
+
+namespace psql_parse {
+
+	Arena::Arena(std::size_t chunk_size)
+	: head_(nullptr)
+	, current_(nullptr)
+	, cursor_(nullptr)
+	, limit_(nullptr)
+	, chunk_size_(chunk_size)
+	, used_(0)
+	, reserved_(0) { }
+
+	Arena::~Arena() {
+		Chunk* chunk = head_;
+		while (chunk != nullptr) {
+			Chunk* next = chunk->next;
+			std::free(chunk);
+			chunk = next;
+		}
+	}
+
+	void* Arena::allocateSlow(std::size_t size, std::size_t align) {
+		std::size_t needed = size + align;
+
+		// Reuse chunks that survived a reset() before growing the chain
+		Chunk* next = current_ == nullptr ? head_ : current_->next;
+		if (next == nullptr || next->size < needed) {
+			std::size_t chunk_size = needed > chunk_size_ ? needed : chunk_size_;
+			auto chunk = static_cast<Chunk*>(std::malloc(sizeof(Chunk) + chunk_size));
+			if (chunk == nullptr) {
+				throw std::bad_alloc();
+			}
+			chunk->size = chunk_size;
+			chunk->next = next;
+			if (current_ == nullptr) {
+				head_ = chunk;
+			} else {
+				current_->next = chunk;
+			}
+			reserved_ += chunk_size;
+			next = chunk;
+		}
+
+		current_ = next;
+		cursor_ = current_->begin();
+		limit_ = current_->end();
+
+		return allocate(size, align);
+	}
+
+	void Arena::reset() {
+		current_ = nullptr;
+		cursor_ = nullptr;
+		limit_ = nullptr;
+		used_ = 0;
+	}
+
+	void Arena::rewind(const Mark& mark) {
+		current_ = mark.chunk;
+		cursor_ = mark.cursor;
+		limit_ = current_ == nullptr ? nullptr : current_->end();
+		used_ = mark.used;
+	}
+
+	void Arena::trim(std::size_t keep) {
+		// Chunks up to and including the current one are in use
+		bool in_use = current_ != nullptr;
+		std::size_t kept = 0;
+
+		Chunk** link = &head_;
+		while (*link != nullptr) {
+			Chunk* chunk = *link;
+			if (in_use || kept + chunk->size <= keep) {
+				in_use = in_use && chunk != current_;
+				kept += chunk->size;
+				link = &chunk->next;
+				continue;
+			}
+			*link = chunk->next;
+			reserved_ -= chunk->size;
+			std::free(chunk);
+		}
+	}
+}
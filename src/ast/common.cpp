@@ -4,7 +4,39 @@
 
 #include "psql_parse/ast/common.hpp"
 
+#include <vector>
+
 namespace psql_parse {
+    QualifiedName::QualifiedName() = default;
+
     QualifiedName::QualifiedName(Name name)
     : qualifier(), name(std::move(name)) {}
-}
\ No newline at end of file
+
+    namespace box_detail {
+        namespace {
+            struct pending {
+                destroyer destroy;
+                void* node;
+            };
+
+            thread_local std::vector<pending> queue;
+            thread_local bool releasing = false;
+        }
+
+        void release(void* node, destroyer destroy) {
+            if (releasing) {
+                queue.push_back({destroy, node});
+                return;
+            }
+
+            releasing = true;
+            destroy(node);
+            while (!queue.empty()) {
+                auto next = queue.back();
+                queue.pop_back();
+                next.destroy(next.node);
+            }
+            releasing = false;
+        }
+    }
+}
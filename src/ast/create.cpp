@@ -6,7 +6,7 @@ namespace psql_parse {
 
 	CreateStatement::CreateStatement(box<QualifiedName> relName, std::optional<Temporary> temp,
 									 std::optional<OnCommit> onCommit,
-									 std::vector<std::variant<ColumnDef, TableConstraint>> elements)
+									 List<std::variant<ColumnDef, TableConstraint>> elements)
 	: rel_name(std::move(relName)), temp(temp), on_commit(onCommit), column_defs(), table_constraints() {
 		if (temp.has_value() && !onCommit.has_value()) {
 			on_commit = OnCommit::DELETE;
@@ -21,6 +21,8 @@ namespace psql_parse {
 		}
 	}
 
+	CreateStatement::CreateStatement() = default;
+
 	CreateStatement::CreateStatement(box<QualifiedName> relName)
 	: rel_name(std::move(relName))
 	, temp(std::nullopt)
@@ -2,6 +2,8 @@
 
 namespace psql_parse {
 
+    DeleteStatement::DeleteStatement() = default;
+
     DeleteStatement::DeleteStatement(box<QualifiedName> tableName, bool only)
     : table_name(std::move(tableName)), only(only) {}
 }
\ No newline at end of file
@@ -2,27 +2,48 @@
 
 namespace psql_parse {
 
+	IntegerLiteral::IntegerLiteral() = default;
+
 	IntegerLiteral::IntegerLiteral(uint64_t value)
 	: value(value) {}
 
+	FloatLiteral::FloatLiteral() = default;
+
 	FloatLiteral::FloatLiteral(double value)
 	: value(value) {}
 
+	StringLiteral::StringLiteral() = default;
+
 	StringLiteral::StringLiteral(std::string &&value, StringLiteralType type)
 	: value(value), type(type) {}
 
+    BooleanLiteral::BooleanLiteral() = default;
+
     BooleanLiteral::BooleanLiteral(Val value)
     : value(value) {}
 
+	Param::Param() = default;
+
+	Param::Param(std::uint64_t number)
+	: number(number) {}
+
+	UnaryOp::UnaryOp() = default;
+
 	UnaryOp::UnaryOp(UnaryOp::Op op, Expression inner)
 	: op(op), inner(std::move(inner)) {}
 
+	BinaryOp::BinaryOp() = default;
+
 	BinaryOp::BinaryOp(Expression left, BinaryOp::Op op, Expression right)
 	: op(op), left(std::move(left)), right(std::move(right)) {}
 
-	AliasExpr::AliasExpr(std::string name, Expression expr)
+	AliasExpr::AliasExpr() = default;
+
+	AliasExpr::AliasExpr(Name name, Expression expr)
 	: name(std::move(name)), expr(std::move(expr)) {}
 
+	JoinExpr::JoinExpr() = default;
+
 	JoinExpr::JoinExpr(RelExpression first, JoinExpr::Kind kind, RelExpression second)
 	: kind(kind), natural(false), first(std::move(first)), second(std::move(second)) {}
 
@@ -34,44 +55,70 @@ namespace psql_parse {
 		qualifier = std::move(expr);
 	}
 
+	TableName::TableName() = default;
+
 	TableName::TableName(box<QualifiedName> name)
 	: name(std::move(name)) {}
 
+    TableAlias::TableAlias() = default;
+
     TableAlias::TableAlias(Name name)
     : name(std::move(name)) {}
 
 	SelectExpr::SelectExpr() = default;
 
+	SetOp::SetOp() = default;
+
 	SetOp::SetOp(RelExpression left, SetOp::Op op, RelExpression right)
 	: op(op), left(std::move(left)), right(std::move(right)) {}
 
+	RowSubquery::RowSubquery() = default;
+
 	RowSubquery::RowSubquery(RelExpression expr)
 	: subquery(std::move(expr)) { }
 
-	Var::Var(std::string name)
+	Var::Var() = default;
+
+	Var::Var(Name name)
 	: name(std::move(name)) {}
 
+	IsExpr::IsExpr() = default;
+
 	IsExpr::IsExpr(Expression inner, box<BooleanLiteral> truth_value)
 	: inner(std::move(inner)), truth_value(std::move(truth_value)) {}
 
+	Collate::Collate() = default;
+
 	Collate::Collate(Expression var, box<QualifiedName> collation)
 	: var(std::move(var)), collation(std::move(collation)) {}
 
+	BetweenPred::BetweenPred() = default;
+
 	BetweenPred::BetweenPred(Expression val, Expression low, Expression high)
 	: val(std::move(val)), low(std::move(low)), high(std::move(high)), symmetric(false) {}
 
-	ValuesExpr::ValuesExpr(std::vector<Expression> rows)
+	ValuesExpr::ValuesExpr() = default;
+
+	ValuesExpr::ValuesExpr(List<Expression> rows)
 	: rows(std::move(rows)) {}
 
+	InPred::InPred() = default;
+
 	InPred::InPred(Expression val, RelExpression rows)
 	: val(std::move(val)), rows(std::move(rows)) {}
 
+	LikePred::LikePred() = default;
+
 	LikePred::LikePred(Expression val, Expression pattern)
 	: val(std::move(val)), pattern(std::move(pattern)), escape(std::nullopt) {}
 
+	ExistsPred::ExistsPred() = default;
+
 	ExistsPred::ExistsPred(box<Query> subquery)
 	: subquery(std::move(subquery)) {}
 
+	UniquePred::UniquePred() = default;
+
 	UniquePred::UniquePred(box<Query> subquery)
 	: subquery(std::move(subquery)) {}
 
@@ -80,12 +127,14 @@ namespace psql_parse {
 
 	SortSpec::SortSpec() = default;
 
+	Query::Query() = default;
+
 	Query::Query(RelExpression expr)
 	: expr(std::move(expr)), order (), offset (std::nullopt), fetch (std::nullopt) {}
 
 	RowExpr::RowExpr() = default;
 
-	RowExpr::RowExpr(std::vector<Expression> exprs)
+	RowExpr::RowExpr(List<Expression> exprs)
 	: exprs(std::move(exprs)) {}
 
 	GroupingSet::GroupingSet() = default;
@@ -93,10 +142,14 @@ namespace psql_parse {
 	Rollup::Rollup() = default;
 	Cube::Cube() = default;
 
+    AggregateExpr::AggregateExpr() = default;
+
     AggregateExpr::AggregateExpr(Op op, Expression argument)
     : op(op), argument(std::move(argument)) {}
 
     WithClause::WithClause() = default;
-    WithSpec::WithSpec(std::string name, box<Query> query)
+    WithSpec::WithSpec() = default;
+
+    WithSpec::WithSpec(Name name, box<Query> query)
     : name(std::move(name)), query(std::move(query)) {}
 }
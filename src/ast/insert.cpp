@@ -2,6 +2,8 @@
 
 namespace psql_parse {
 
+    InsertStatement::InsertStatement() = default;
+
     InsertStatement::InsertStatement(box<QualifiedName> tableName)
     : table_name(std::move(tableName)) {}
 
@@ -1,4 +1,6 @@
 #include "psql_parse/ast/select.hpp"
 
+psql_parse::SelectStatement::SelectStatement() = default;
+
 psql_parse::SelectStatement::SelectStatement(psql_parse::box<psql_parse::Query> queryExpr)
 : rel_expr(std::move(queryExpr)) {}
@@ -1,15 +1,24 @@
 #include "psql_parse/ast/stmt.hpp"
-//
-//namespace psql_parse {
-//
-//	Statement::Statement(location loc)
-//	: Node { loc } { }
-//
-//	ExprStatement::ExprStatement(location loc, Expression *expr)
-//	: Statement(loc), expr(expr) {}
-//
-//	const Expression* ExprStatement::getExpr() const {
-//		return expr.get();
-//	}
-//
-//}
\ No newline at end of file
+
+namespace psql_parse {
+
+	namespace {
+		template <class Variant>
+		const location& locationOfAlternative(const Variant& node) {
+			return std::visit([](const auto& alt) -> const location& { return alt->loc; }, node);
+		}
+	}
+
+	const location& locationOf(const Expression& expr) {
+		return locationOfAlternative(expr);
+	}
+
+	const location& locationOf(const RelExpression& expr) {
+		return locationOfAlternative(expr);
+	}
+
+	const location& locationOf(const Statement& stmt) {
+		return locationOfAlternative(stmt);
+	}
+
+}
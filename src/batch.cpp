@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "psql_parse/batch.hpp"
+#include "psql_parse/driver.hpp"
+
+namespace psql_parse {
+
+	namespace {
+		/*
+		 * The queries a worker has left, [begin, end) packed into one word.
+		 * The owner takes from the front and thieves take from the back,
+		 * both with a single compare-and-swap.
+		 */
+		class alignas(64) WorkRange {
+			std::atomic<std::uint64_t> range_ { 0 };
+
+			static std::uint64_t pack(std::uint32_t begin, std::uint32_t end) {
+				return (static_cast<std::uint64_t>(begin) << 32) | end;
+			}
+
+			static std::uint32_t begin(std::uint64_t range) { return static_cast<std::uint32_t>(range >> 32); }
+			static std::uint32_t end(std::uint64_t range) { return static_cast<std::uint32_t>(range); }
+
+		public:
+			void assign(std::uint32_t begin, std::uint32_t end) {
+				range_.store(pack(begin, end), std::memory_order_release);
+			}
+
+			[[nodiscard]] std::uint32_t size() const {
+				auto range = range_.load(std::memory_order_relaxed);
+				return begin(range) < end(range) ? end(range) - begin(range) : 0;
+			}
+
+			std::optional<std::uint32_t> pop() {
+				auto range = range_.load(std::memory_order_acquire);
+				while (begin(range) < end(range)) {
+					if (range_.compare_exchange_weak(range, pack(begin(range) + 1, end(range)),
+													 std::memory_order_acq_rel)) {
+						return begin(range);
+					}
+				}
+				return std::nullopt;
+			}
+
+			/* Take the upper half (at least one query) of what is left */
+			std::optional<std::pair<std::uint32_t, std::uint32_t>> steal() {
+				auto range = range_.load(std::memory_order_acquire);
+				while (begin(range) < end(range)) {
+					auto mid = begin(range) + (end(range) - begin(range)) / 2;
+					if (range_.compare_exchange_weak(range, pack(begin(range), mid),
+													 std::memory_order_acq_rel)) {
+						return std::make_pair(mid, end(range));
+					}
+				}
+				return std::nullopt;
+			}
+		};
+	}
+
+	auto parseBatch(std::span<const std::string_view> queries, unsigned threads)
+		-> std::vector<std::optional<Statement>> {
+		if (queries.size() > std::numeric_limits<std::uint32_t>::max()) {
+			throw std::length_error("parseBatch: too many queries");
+		}
+
+		std::vector<std::optional<Statement>> results(queries.size());
+		if (queries.empty()) {
+			return results;
+		}
+
+		if (threads == 0) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		if (threads > queries.size()) {
+			threads = static_cast<unsigned>(queries.size());
+		}
+
+		std::vector<WorkRange> ranges(threads);
+		auto n = static_cast<std::uint64_t>(queries.size());
+		for (unsigned w = 0; w < threads; w++) {
+			ranges[w].assign(static_cast<std::uint32_t>(n * w / threads),
+							 static_cast<std::uint32_t>(n * (w + 1) / threads));
+		}
+
+		std::mutex error_mutex;
+		std::exception_ptr error;
+
+		auto work = [&](unsigned self) {
+			try {
+				driver drv;
+				for (;;) {
+					while (auto i = ranges[self].pop()) {
+						if (drv.parse(queries[*i])) {
+							results[*i] = std::move(drv.getResult());
+						}
+					}
+
+					// Steal from whoever has the most left, stop once everyone is done
+					unsigned victim = self;
+					std::uint32_t most = 0;
+					for (unsigned w = 0; w < threads; w++) {
+						auto size = ranges[w].size();
+						if (w != self && size > most) {
+							victim = w;
+							most = size;
+						}
+					}
+					if (most == 0) {
+						break;
+					}
+					if (auto stolen = ranges[victim].steal()) {
+						ranges[self].assign(stolen->first, stolen->second);
+					}
+				}
+			} catch (...) {
+				std::lock_guard lock(error_mutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+		};
+
+		std::vector<std::thread> workers;
+		workers.reserve(threads - 1);
+		for (unsigned w = 1; w < threads; w++) {
+			workers.emplace_back(work, w);
+		}
+		work(0);
+		for (auto& worker : workers) {
+			worker.join();
+		}
+
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		return results;
+	}
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "psql_parse/cache.hpp"
+#include "psql_parse/driver.hpp"
+
+namespace psql_parse {
+
+	namespace {
+		struct Entry {
+			std::size_t hash;
+			std::string query;
+			std::shared_ptr<const Statement> statement;
+		};
+
+		/* The hash is computed once per lookup and reused for shard and bucket */
+		struct Key {
+			std::size_t hash;
+			std::string_view query;
+
+			bool operator==(const Key& other) const {
+				return hash == other.hash && query == other.query;
+			}
+		};
+
+		struct KeyHash {
+			std::size_t operator()(const Key& key) const { return key.hash; }
+		};
+
+		std::shared_ptr<const Statement> parseOne(std::string_view query) {
+			thread_local driver drv;
+			if (!drv.parse(query)) {
+				return nullptr;
+			}
+			return std::make_shared<const Statement>(std::move(drv.getResult()));
+		}
+	}
+
+	struct alignas(64) ParseCache::Shard {
+		mutable std::mutex mutex;
+
+		// most recently used first
+		std::list<Entry> lru;
+		std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+		std::size_t capacity = 0;
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		std::uint64_t evictions = 0;
+
+		std::shared_ptr<const Statement> touch(const Key& key) {
+			auto it = index.find(key);
+			if (it == index.end()) {
+				return nullptr;
+			}
+			lru.splice(lru.begin(), lru, it->second);
+			return it->second->statement;
+		}
+	};
+
+	ParseCache::ParseCache(std::size_t capacity, unsigned shards)
+	: capacity_(capacity) {
+		if (capacity == 0) {
+			throw std::invalid_argument("ParseCache: capacity must be at least 1");
+		}
+		shard_count_ = static_cast<unsigned>(std::clamp<std::size_t>(shards, 1, capacity));
+		shards_ = std::make_unique<Shard[]>(shard_count_);
+
+		// spread the remainder so the shard capacities add up to capacity
+		for (unsigned s = 0; s < shard_count_; s++) {
+			shards_[s].capacity = capacity / shard_count_ + (s < capacity % shard_count_ ? 1 : 0);
+		}
+	}
+
+	ParseCache::~ParseCache() = default;
+
+	std::shared_ptr<const Statement> ParseCache::get(std::string_view query) {
+		Key key { std::hash<std::string_view>{}(query), query };
+		auto& shard = shards_[key.hash % shard_count_];
+
+		{
+			std::lock_guard lock(shard.mutex);
+			if (auto stmt = shard.touch(key)) {
+				shard.hits++;
+				return stmt;
+			}
+			shard.misses++;
+		}
+
+		auto stmt = parseOne(query);
+		if (!stmt) {
+			return nullptr;
+		}
+
+		// released after the lock, so an evicted tree is not freed while holding it
+		std::shared_ptr<const Statement> evicted;
+		std::lock_guard lock(shard.mutex);
+
+		// another thread may have parsed the same query in between
+		if (auto existing = shard.touch(key)) {
+			return existing;
+		}
+
+		shard.lru.push_front(Entry { key.hash, std::string(query), stmt });
+		shard.index.emplace(Key { key.hash, shard.lru.front().query }, shard.lru.begin());
+
+		if (shard.lru.size() > shard.capacity) {
+			auto& oldest = shard.lru.back();
+			shard.index.erase(Key { oldest.hash, oldest.query });
+			evicted = std::move(oldest.statement);
+			shard.lru.pop_back();
+			shard.evictions++;
+		}
+		return stmt;
+	}
+
+	void ParseCache::clear() {
+		for (unsigned s = 0; s < shard_count_; s++) {
+			std::list<Entry> dropped;
+			std::lock_guard lock(shards_[s].mutex);
+			shards_[s].index.clear();
+			dropped.swap(shards_[s].lru);
+		}
+	}
+
+	ParseCache::Stats ParseCache::stats() const {
+		Stats stats {};
+		for (unsigned s = 0; s < shard_count_; s++) {
+			std::lock_guard lock(shards_[s].mutex);
+			stats.hits += shards_[s].hits;
+			stats.misses += shards_[s].misses;
+			stats.evictions += shards_[s].evictions;
+			stats.size += shards_[s].lru.size();
+		}
+		return stats;
+	}
+}
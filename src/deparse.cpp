@@ -0,0 +1,1100 @@
+#include <charconv>
+#include <string_view>
+
+#include "psql_parse/deparse.hpp"
+#include "psql_parse/keywords.hpp"
+#include "psql_parse/visit.hpp"
+
+namespace psql_parse {
+
+	namespace {
+		/*
+		 * Every print() writes the SQL of one kind of node. Where the
+		 * grammar only accepts part of the language, for example column
+		 * references in GROUP BY or literals in DEFAULT, a separate
+		 * function prints the node the restricted way.
+		 *
+		 * Nodes that can nest without bound (expressions, query bodies,
+		 * FROM elements, groupings and data types) are printed through
+		 * the work stack, which queues them once the tree gets deep. Once
+		 * something is queued, the text that follows it has to wait its
+		 * turn as well, so the leaves queue themselves too instead of
+		 * writing to out; what they print must therefore live in the tree.
+		 */
+		struct deparser {
+			using stack = work_stack<deparser, const void>;
+
+			std::string& out;
+			stack& work;
+
+			template <class X, void (deparser::*Print)(const X&)>
+			static void step(deparser& self, const void* node) {
+				(self.*Print)(*static_cast<const X*>(node));
+			}
+
+			template <class X, void (deparser::*Print)(const X&)>
+			void nested(const X& node) {
+				work.template call<&step<X, Print>>(*this, &node);
+			}
+
+			template <class X, void (deparser::*Print)(const X&)>
+			void later(const X& node) {
+				work.later(&step<X, Print>, &node);
+			}
+
+			void print(const char* text) {
+				if (work.idle()) {
+					out.append(text);
+				} else {
+					work.later([](deparser& self, const void* t) { self.out.append(static_cast<const char*>(t)); }, text);
+				}
+			}
+
+			void print(const std::uint64_t& value) {
+				if (work.idle()) {
+					number(value);
+				} else {
+					later<std::uint64_t, &deparser::number>(value);
+				}
+			}
+
+			void print(const double& value) {
+				if (work.idle()) {
+					number(value);
+				} else {
+					later<double, &deparser::number>(value);
+				}
+			}
+
+			void print(const Name& name) {
+				if (work.idle()) {
+					identifier(name);
+				} else {
+					later<Name, &deparser::identifier>(name);
+				}
+			}
+
+			// a queued leaf keeps a pointer to its value, a temporary would be gone by then
+			void print(std::uint64_t&&) = delete;
+			void print(double&&) = delete;
+
+			void number(const std::uint64_t& value) {
+				char buffer[20];
+				auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+				out.append(buffer, result.ptr);
+			}
+
+			// shortest text that reads back as the same double; the scanner has no exponents
+			void number(const double& value) {
+				char buffer[400];
+				auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed);
+				std::string_view text(buffer, result.ptr - buffer);
+				out.append(text);
+				if (text.find('.') == std::string_view::npos) {
+					out.append(".0");
+				}
+			}
+
+			// quoted unless it reads back as the same identifier; quoted names cannot hold '"'
+			void identifier(const Name& name) {
+				auto text = name.str();
+				bool plain = !text.empty() && !(text[0] >= '0' && text[0] <= '9')
+						&& !keyword_table.find(text);
+				for (char c : text) {
+					plain = plain && ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_');
+				}
+				if (plain) {
+					out.append(text);
+				} else {
+					out.push_back('"');
+					out.append(text);
+					out.push_back('"');
+				}
+			}
+
+			void print(const QualifiedName& name) {
+				for (auto& part : name.qualifier) {
+					print(part);
+					print(".");
+				}
+				print(name.name);
+			}
+
+			void print(const List<Name>& names) {
+				list(names, [&](const Name& name) { print(name); });
+			}
+
+			template <class List, class Each>
+			void list(const List& elements, Each&& each) {
+				bool first = true;
+				for (auto& element : elements) {
+					if (!first) {
+						print(", ");
+					}
+					each(element);
+					first = false;
+				}
+			}
+
+			void print(SetQuantifier quantifier) {
+				print(quantifier == SetQuantifier::ALL ? "ALL" : "DISTINCT");
+			}
+
+			/*
+			 * Statements
+			 */
+
+			void print(const Statement& stmt) {
+				std::visit([&](auto& node) { print(node); }, stmt);
+			}
+
+			void print(const box<SelectStatement>& stmt) {
+				query(*stmt->rel_expr);
+			}
+
+			void print(const box<InsertStatement>& stmt) {
+				print("INSERT INTO ");
+				print(*stmt->table_name);
+				if (!stmt->column_names.empty()) {
+					print(" (");
+					print(stmt->column_names);
+					print(")");
+				}
+				if (stmt->override.has_value()) {
+					print(stmt->override == InsertStatement::Override::USER_VALUE
+							? " OVERRIDING USER VALUE" : " OVERRIDING SYSTEM VALUE");
+				}
+				if (std::holds_alternative<InsertStatement::Default>(stmt->source)) {
+					print(" DEFAULT VALUES");
+				} else {
+					print(" ");
+					query(*std::get<box<Query>>(stmt->source));
+				}
+			}
+
+			void print(const box<DeleteStatement>& stmt) {
+				print("DELETE FROM ");
+				if (stmt->only) {
+					print("ONLY (");
+					print(*stmt->table_name);
+					print(")");
+				} else {
+					print(*stmt->table_name);
+				}
+				if (stmt->where.has_value()) {
+					print(" WHERE ");
+					print(*stmt->where);
+				}
+			}
+
+			void print(const box<CreateStatement>& stmt) {
+				print("CREATE ");
+				if (stmt->temp.has_value()) {
+					print(stmt->temp == Temporary::LOCAL ? "LOCAL TEMPORARY " : "GLOBAL TEMPORARY ");
+				}
+				print("TABLE ");
+				print(*stmt->rel_name);
+				print(" (");
+				list(stmt->column_defs, [&](const ColumnDef& def) { print(def); });
+				if (!stmt->column_defs.empty() && !stmt->table_constraints.empty()) {
+					print(", ");
+				}
+				list(stmt->table_constraints, [&](const TableConstraint& constraint) { print(constraint); });
+				print(")");
+				if (stmt->on_commit.has_value()) {
+					print(stmt->on_commit == OnCommit::DELETE ? " ON COMMIT DELETE ROWS" : " ON COMMIT PRESERVE ROWS");
+				}
+			}
+
+			void print(const ColumnDef& def) {
+				print(def.name);
+				print(" ");
+				print(def.type);
+				if (def.col_default.has_value()) {
+					print(" DEFAULT ");
+					std::visit([&](auto& option) { columnDefault(option); }, *def.col_default);
+				}
+				for (auto& constraint : def.col_constraint) {
+					print(" ");
+					if (constraint.name.has_value()) {
+						print("CONSTRAINT ");
+						print(**constraint.name);
+						print(" ");
+					}
+					std::visit([&](auto& c) { print(c); }, constraint.constraint);
+				}
+				if (def.collate.has_value()) {
+					print(" COLLATE ");
+					print(**def.collate);
+				}
+			}
+
+			void columnDefault(UserSpec user) {
+				switch (user) {
+					case UserSpec::CURRENT_USER:
+						print("CURRENT_USER");
+						break;
+					case UserSpec::SESSION_USER:
+						print("SESSION_USER");
+						break;
+					case UserSpec::SYSTEM_USER:
+						print("SYSTEM_USER");
+						break;
+				}
+			}
+
+			void columnDefault(V_NULL) {
+				print("NULL");
+			}
+
+			void columnDefault(const Expression& literal) {
+				signedLiteral(literal);
+			}
+
+			void print(ConstraintType type) {
+				switch (type) {
+					case ConstraintType::NOT_NULL:
+						print("NOT NULL");
+						break;
+					case ConstraintType::UNIQUE:
+						print("UNIQUE");
+						break;
+					case ConstraintType::PRIMARY_KEY:
+						print("PRIMARY KEY");
+						break;
+				}
+			}
+
+			void print(const box<References>& references) {
+				print("REFERENCES ");
+				print(*references->rel_name);
+				print(" (");
+				print(references->col_names);
+				print(")");
+				if (references->match_type == MatchOption::FULL) {
+					print(" MATCH FULL");
+				} else if (references->match_type == MatchOption::PARTIAL) {
+					print(" MATCH PARTIAL");
+				}
+				if (references->action.on_update != ReferentialAction::NO_ACTION) {
+					print(" ON UPDATE ");
+					print(references->action.on_update);
+				}
+				if (references->action.on_delete != ReferentialAction::NO_ACTION) {
+					print(" ON DELETE ");
+					print(references->action.on_delete);
+				}
+			}
+
+			void print(ReferentialAction action) {
+				switch (action) {
+					case ReferentialAction::CASCADE:
+						print("CASCADE");
+						break;
+					case ReferentialAction::SET_NULL:
+						print("SET NULL");
+						break;
+					case ReferentialAction::SET_DEFAULT:
+						print("SET DEFAULT");
+						break;
+					case ReferentialAction::NO_ACTION:
+						print("NO ACTION");
+						break;
+				}
+			}
+
+			void print(const TableConstraint& constraint) {
+				std::visit([&](auto& c) { print(c); }, constraint);
+			}
+
+			void print(const TableUniqueConstraint& constraint) {
+				print("UNIQUE (");
+				print(constraint.column_names);
+				print(")");
+			}
+
+			void print(const TablePrimaryKeyConstraint& constraint) {
+				print("PRIMARY KEY (");
+				print(constraint.column_names);
+				print(")");
+			}
+
+			void print(const TableForeignKeyConstraint& constraint) {
+				print("FOREIGN KEY (");
+				print(constraint.column_names);
+				print(") ");
+				print(constraint.references);
+			}
+
+			/*
+			 * Data types
+			 */
+
+			void print(const DataType& type) {
+				nested<DataType, &deparser::visitType>(type);
+			}
+
+			void visitType(const DataType& type) {
+				std::visit([&](auto& t) { print(t); }, type);
+			}
+
+			void precision(const std::optional<std::uint64_t>& precision, const std::optional<std::uint64_t>& scale = std::nullopt) {
+				if (precision.has_value()) {
+					print("(");
+					print(*precision);
+					if (scale.has_value()) {
+						print(", ");
+						print(*scale);
+					}
+					print(")");
+				}
+			}
+
+			void print(const CharLength& length) {
+				print(" ");
+				print(length.length);
+				if (length.unit.has_value()) {
+					print(length.unit == CharLength::Unit::CHARACTERS ? " CHARACTERS" : " OCTETS");
+				}
+			}
+
+			void print(const std::optional<CharLength>& length) {
+				if (length.has_value()) {
+					print(*length);
+				}
+			}
+
+			void timezone(const std::optional<bool>& with_timezone) {
+				if (with_timezone.has_value()) {
+					print(*with_timezone ? " WITH TIME ZONE" : " WITHOUT TIME ZONE");
+				}
+			}
+
+			void print(const NumericType& type) { print("NUMERIC"); precision(type.precision, type.scale); }
+			void print(const DecimalType& type) { print("DECIMAL"); precision(type.precision, type.scale); }
+			void print(const SmallIntType&) { print("SMALLINT"); }
+			void print(const IntegerType&) { print("INTEGER"); }
+			void print(const BigIntType&) { print("BIGINT"); }
+			void print(const FloatType& type) { print("FLOAT"); precision(type.precision); }
+			void print(const RealType&) { print("REAL"); }
+			void print(const DoublePrecisionType&) { print("DOUBLE PRECISION"); }
+			void print(const BinaryType& type) { print("BINARY"); precision(type.length); }
+			void print(const VarBinaryType& type) { print("VARBINARY"); precision(type.length); }
+			void print(const BlobType& type) { print("BLOB"); precision(type.length); }
+			void print(const CharType& type) { print("CHARACTER"); print(type.length); }
+			void print(const VarCharType& type) { print("VARCHAR"); print(type.length); }
+			void print(const ClobType& type) { print("CLOB"); print(type.length); }
+			void print(const NationalCharType& type) { print("NCHAR"); print(type.length); }
+			void print(const NationalVarCharType& type) { print("NCHAR VARYING"); print(type.length); }
+			void print(const NationalClobType& type) { print("NCLOB"); print(type.length); }
+			void print(const BooleanType&) { print("BOOLEAN"); }
+			void print(const DateType&) { print("DATE"); }
+			void print(const TimeType& type) { print("TIME"); precision(type.precision); timezone(type.with_timezone); }
+			void print(const TimestampType& type) { print("TIMESTAMP"); precision(type.precision); timezone(type.with_timezone); }
+			void print(const UserDefinedType& type) { print(*type.name); }
+
+			void print(const box<RowType>& type) {
+				print("ROW (");
+				list(type->fields, [&](const RowType::FieldDef& field) {
+					print(field.first);
+					print(" ");
+					print(field.second);
+				});
+				print(")");
+			}
+
+			void print(const box<RefType>& type) {
+				print("REF (");
+				print(type->type);
+				print(")");
+				if (type->scope.has_value()) {
+					print(" SCOPE ");
+					print(**type->scope);
+				}
+			}
+
+			void print(const box<ArrayType>& type) {
+				print(type->type);
+				print(" ARRAY");
+				if (type->max_cardinality.has_value()) {
+					print("[");
+					print(*type->max_cardinality);
+					print("]");
+				}
+			}
+
+			void print(const box<MultiSetType>& type) {
+				print(type->type);
+				print(" MULTISET");
+			}
+
+			/*
+			 * Query expressions
+			 */
+
+			// a query without the parentheses of a subquery
+			void query(const Query& query) {
+				if (query.with.has_value()) {
+					auto& with = **query.with;
+					print(with.recursive ? "WITH RECURSIVE " : "WITH ");
+					list(with.elements, [&](const box<WithSpec>& spec) {
+						print(spec->name);
+						if (spec->columns.has_value()) {
+							print(" (");
+							print(*spec->columns);
+							print(")");
+						}
+						print(" AS ");
+						subquery(*spec->query);
+					});
+					print(" ");
+				}
+
+				body(query.expr);
+
+				if (!query.order.empty()) {
+					print(" ORDER BY ");
+					list(query.order, [&](const box<SortSpec>& spec) { print(spec); });
+				}
+				if (query.offset.has_value()) {
+					print(" OFFSET ");
+					print((*query.offset)->value);
+					print(" ROWS");
+				}
+				if (query.fetch.has_value()) {
+					auto& fetch = *query.fetch;
+					print(fetch.kind == Fetch::Kind::FIRST ? " FETCH FIRST" : " FETCH NEXT");
+					if (fetch.value.has_value()) {
+						print(" ");
+						print((*fetch.value)->value);
+					}
+					if (fetch.percent) {
+						print(" PERCENT");
+					}
+					print(fetch.with_ties ? " ROWS WITH TIES" : " ROWS ONLY");
+				}
+			}
+
+			void subquery(const Query& inner) {
+				print("(");
+				query(inner);
+				print(")");
+			}
+
+			// the part of a query before ORDER BY, or an operand of UNION and friends
+			void body(const RelExpression& expr) {
+				nested<RelExpression, &deparser::visitBody>(expr);
+			}
+
+			void visitBody(const RelExpression& expr) {
+				std::visit([&](auto& node) { body(node); }, expr);
+			}
+
+			void body(const box<Query>& expr) {
+				subquery(*expr);
+			}
+
+			void body(const box<TableName>& expr) {
+				print("TABLE ");
+				print(*expr->name);
+			}
+
+			void body(const box<ValuesExpr>& expr) {
+				print("VALUES (");
+				list(expr->rows, [&](const Expression& row) { print(row); });
+				print(")");
+			}
+
+			void body(const box<SetOp>& expr) {
+				body(expr->left);
+				switch (expr->op) {
+					case SetOp::Op::UNION:
+						print(" UNION ");
+						break;
+					case SetOp::Op::INTERSECT:
+						print(" INTERSECT ");
+						break;
+					case SetOp::Op::EXCEPT:
+						print(" EXCEPT ");
+						break;
+				}
+				if (expr->quantifier.has_value()) {
+					print(*expr->quantifier);
+					print(" ");
+				}
+				body(expr->right);
+			}
+
+			void body(const box<SelectExpr>& expr) {
+				print("SELECT ");
+				if (expr->set_quantifier.has_value()) {
+					print(*expr->set_quantifier);
+					print(" ");
+				}
+				list(expr->target_list, [&](const Expression& target) { print(target); });
+
+				if (!expr->from_clause.empty()) {
+					print(" FROM ");
+					list(expr->from_clause, [&](const RelExpression& from) { table(from); });
+				}
+				if (expr->where_clause.has_value()) {
+					print(" WHERE ");
+					print(*expr->where_clause);
+				}
+				if (expr->group_clause.has_value()) {
+					print(" GROUP BY ");
+					if (expr->group_clause->group_quantifier.has_value()) {
+						print(*expr->group_clause->group_quantifier);
+						print(" ");
+					}
+					list(expr->group_clause->group_clause, [&](const Grouping& grouping) { print(grouping); });
+				}
+				if (expr->having_clause.has_value()) {
+					print(" HAVING ");
+					print(*expr->having_clause);
+				}
+				if (!expr->window_clause.empty()) {
+					print(" WINDOW ");
+					list(expr->window_clause, [&](const box<Window>& window) { print(window); });
+				}
+			}
+
+			// joins and aliases only occur in FROM
+			void body(const box<JoinExpr>& expr) {
+				table(expr);
+			}
+
+			void body(const box<TableAlias>& expr) {
+				table(expr);
+			}
+
+			// an element of FROM
+			void table(const RelExpression& expr) {
+				nested<RelExpression, &deparser::visitTable>(expr);
+			}
+
+			void visitTable(const RelExpression& expr) {
+				std::visit([&](auto& node) { table(node); }, expr);
+			}
+
+			void table(const box<TableName>& expr) {
+				print(*expr->name);
+			}
+
+			void table(const box<TableAlias>& expr) {
+				table(expr->expression);
+				print(" AS ");
+				print(expr->name);
+				if (!expr->columns.empty()) {
+					print(" (");
+					print(expr->columns);
+					print(")");
+				}
+			}
+
+			// parentheses around a join never add a node, so every join gets them
+			void table(const box<JoinExpr>& expr) {
+				print("(");
+				table(expr->first);
+				if (expr->natural) {
+					print(" NATURAL");
+				}
+				bool cross = !expr->natural && !expr->qualifier.has_value() && expr->columns.empty();
+				switch (expr->kind) {
+					case JoinExpr::Kind::FULL:
+						print(" FULL JOIN ");
+						break;
+					case JoinExpr::Kind::LEFT:
+						print(" LEFT JOIN ");
+						break;
+					case JoinExpr::Kind::RIGHT:
+						print(" RIGHT JOIN ");
+						break;
+					case JoinExpr::Kind::INNER:
+						print(cross ? " CROSS JOIN " : " JOIN ");
+						break;
+				}
+				table(expr->second);
+				if (expr->qualifier.has_value()) {
+					print(" ON ");
+					print(*expr->qualifier);
+				} else if (!expr->columns.empty()) {
+					print(" USING (");
+					print(expr->columns);
+					print(")");
+				}
+				print(")");
+			}
+
+			void table(const box<Query>& expr) {
+				subquery(*expr);
+			}
+
+			// not produced by the parser, a subquery is the closest
+			template <class Node>
+			void table(const box<Node>& expr) {
+				print("(");
+				body(expr);
+				print(")");
+			}
+
+			/*
+			 * GROUP BY and WINDOW
+			 */
+
+			void print(const Grouping& grouping) {
+				nested<Grouping, &deparser::visitGrouping>(grouping);
+			}
+
+			void visitGrouping(const Grouping& grouping) {
+				std::visit([&](auto& node) { print(node); }, grouping);
+			}
+
+			void print(const box<GroupingSet>& set) {
+				print("(");
+				list(set->columns, [&](const Expression& column) { columnRef(column); });
+				print(")");
+			}
+
+			void print(const box<GroupingSets>& sets) {
+				print("GROUPING SETS (");
+				list(sets->sets, [&](const Grouping& grouping) { print(grouping); });
+				print(")");
+			}
+
+			void print(const box<Rollup>& rollup) {
+				print("ROLLUP (");
+				list(rollup->sets, [&](const box<GroupingSet>& set) { print(set); });
+				print(")");
+			}
+
+			void print(const box<Cube>& cube) {
+				print("CUBE (");
+				list(cube->sets, [&](const box<GroupingSet>& set) { print(set); });
+				print(")");
+			}
+
+			// a name, optionally with COLLATE, as GROUP BY and PARTITION BY take them
+			void columnRef(const Expression& expr) {
+				if (auto collate = std::get_if<box<Collate>>(&expr)) {
+					nested<Expression, &deparser::columnRef>((*collate)->var);
+					print(" COLLATE ");
+					print(*(*collate)->collation);
+				} else {
+					print(expr);
+				}
+			}
+
+			void print(const box<Window>& window) {
+				print(window->window_name);
+				print(" AS (");
+				bool space = false;
+				auto separate = [&]() {
+					if (space) {
+						print(" ");
+					}
+					space = true;
+				};
+				if (window->existing_window.has_value()) {
+					separate();
+					print(*window->existing_window);
+				}
+				if (!window->partition.empty()) {
+					separate();
+					print("PARTITION BY ");
+					list(window->partition, [&](const Expression& column) { columnRef(column); });
+				}
+				if (!window->sort.empty()) {
+					separate();
+					print("ORDER BY ");
+					list(window->sort, [&](const box<SortSpec>& spec) { print(spec); });
+				}
+				if (window->frame.has_value()) {
+					separate();
+					print(*window->frame);
+				}
+				print(")");
+			}
+
+			void print(const Window::Frame& frame) {
+				switch (frame.unit) {
+					case Window::Frame::Unit::ROWS:
+						print("ROWS ");
+						break;
+					case Window::Frame::Unit::RANGE:
+						print("RANGE ");
+						break;
+					case Window::Frame::Unit::GROUPS:
+						print("GROUPS ");
+						break;
+				}
+				if (frame.end.has_value()) {
+					print("BETWEEN ");
+					print(frame.start);
+					print(" AND ");
+					print(*frame.end);
+				} else {
+					print(frame.start);
+				}
+				if (frame.exclude.has_value()) {
+					switch (*frame.exclude) {
+						case Window::Frame::Exclusion::CURRENT_ROW:
+							print(" EXCLUDE CURRENT ROW");
+							break;
+						case Window::Frame::Exclusion::GROUP:
+							print(" EXCLUDE GROUP");
+							break;
+						case Window::Frame::Exclusion::TIES:
+							print(" EXCLUDE TIES");
+							break;
+						case Window::Frame::Exclusion::NO_OTHERS:
+							print(" EXCLUDE NO OTHERS");
+							break;
+					}
+				}
+			}
+
+			// CURRENT ROW is kept as UNBOUNDED PRECEDING, both are an empty bound
+			void print(const Window::Frame::Bound& bound) {
+				bool unbounded = std::visit([](auto& node) { return node.operator->() == nullptr; }, bound.second);
+				if (unbounded) {
+					print("UNBOUNDED");
+				} else {
+					print(bound.second);
+				}
+				print(bound.first == Window::Frame::BoundKind::FOLLOWING ? " FOLLOWING" : " PRECEDING");
+			}
+
+			void print(const box<SortSpec>& spec) {
+				print(spec->expr);
+				if (spec->order == SortSpec::Order::DESC) {
+					print(" DESC");
+				}
+				if (spec->null_order == SortSpec::NullOrder::FIRST) {
+					print(" NULLS FIRST");
+				} else if (spec->null_order == SortSpec::NullOrder::LAST) {
+					print(" NULLS LAST");
+				}
+			}
+
+			/*
+			 * Value expressions. Anything but a name, a literal, a
+			 * parameter or a function call is printed in parentheses,
+			 * which the grammar drops again, so precedence never has to
+			 * be reconstructed.
+			 */
+
+			void print(const Expression& expr) {
+				nested<Expression, &deparser::visitExpression>(expr);
+			}
+
+			void visitExpression(const Expression& expr) {
+				std::visit([&](auto& node) { print(node); }, expr);
+			}
+
+			// DEFAULT takes a literal with an optional sign
+			void signedLiteral(const Expression& expr) {
+				if (auto op = std::get_if<box<UnaryOp>>(&expr); op && (*op)->op == UnaryOp::Op::NEG) {
+					print("-");
+					print((*op)->inner);
+				} else {
+					print(expr);
+				}
+			}
+
+			void print(const box<Asterisk>&) {
+				print("*");
+			}
+
+			void print(const box<IntegerLiteral>& expr) {
+				print(expr->value);
+			}
+
+			void print(const box<FloatLiteral>& expr) {
+				print(expr->value);
+			}
+
+			void print(const box<StringLiteral>& expr) {
+				switch (expr->type) {
+					case StringLiteralType::BIT:
+						print("B");
+						break;
+					case StringLiteralType::HEX:
+						print("X");
+						break;
+					case StringLiteralType::NATIONAL:
+						print("N");
+						break;
+					case StringLiteralType::CHAR:
+						break;
+				}
+				out.push_back('\'');
+				std::string_view rest = expr->value;
+				for (auto quote = rest.find('\''); quote != std::string_view::npos; quote = rest.find('\'')) {
+					out.append(rest.substr(0, quote + 1));
+					out.push_back('\'');
+					rest.remove_prefix(quote + 1);
+				}
+				out.append(rest);
+				out.push_back('\'');
+			}
+
+			void print(const box<BooleanLiteral>& expr) {
+				switch (expr->value) {
+					case BooleanLiteral::Val::TRUE:
+						print("TRUE");
+						break;
+					case BooleanLiteral::Val::FALSE:
+						print("FALSE");
+						break;
+					case BooleanLiteral::Val::UNKNOWN:
+						print("UNKNOWN");
+						break;
+				}
+			}
+
+			void print(const box<Param>& expr) {
+				print("$");
+				print(expr->number);
+			}
+
+			void print(const box<Var>& expr) {
+				print(expr->name);
+			}
+
+			// only valid as an element of the select list
+			void print(const box<AliasExpr>& expr) {
+				print(expr->expr);
+				print(" AS ");
+				print(expr->name);
+			}
+
+			void print(const box<UnaryOp>& expr) {
+				print(expr->op == UnaryOp::Op::NOT ? "(NOT " : "(- ");
+				print(expr->inner);
+				print(")");
+			}
+
+			void print(const box<BinaryOp>& expr) {
+				print("(");
+				print(expr->left);
+				switch (expr->op) {
+					case BinaryOp::Op::OR:
+						print(" OR ");
+						break;
+					case BinaryOp::Op::AND:
+						print(" AND ");
+						break;
+					case BinaryOp::Op::ADD:
+						print(" + ");
+						break;
+					case BinaryOp::Op::SUB:
+						print(" - ");
+						break;
+					case BinaryOp::Op::MULT:
+						print(" * ");
+						break;
+					case BinaryOp::Op::DIV:
+						print(" / ");
+						break;
+					case BinaryOp::Op::LESS:
+						print(" < ");
+						break;
+					case BinaryOp::Op::LESS_EQUAL:
+						print(" <= ");
+						break;
+					case BinaryOp::Op::GREATER:
+						print(" > ");
+						break;
+					case BinaryOp::Op::GREATER_EQUAL:
+						print(" >= ");
+						break;
+					case BinaryOp::Op::EQUAL:
+						print(" = ");
+						break;
+					case BinaryOp::Op::NOT_EQUAL:
+						print(" <> ");
+						break;
+					case BinaryOp::Op::CONCAT:
+						print(" || ");
+						break;
+				}
+				print(expr->right);
+				print(")");
+			}
+
+			void print(const box<RowExpr>& expr) {
+				print("(ROW (");
+				list(expr->exprs, [&](const Expression& e) { print(e); });
+				print("))");
+			}
+
+			void print(const box<RowSubquery>& expr) {
+				if (auto inner = std::get_if<box<Query>>(&expr->subquery)) {
+					subquery(**inner);
+				} else {
+					print("(");
+					body(expr->subquery);
+					print(")");
+				}
+			}
+
+			void print(const box<Collate>& expr) {
+				print("(");
+				print(expr->var);
+				print(" COLLATE ");
+				print(*expr->collation);
+				print(")");
+			}
+
+			void print(const box<IsExpr>& expr) {
+				print("(");
+				print(expr->inner);
+				print(" IS ");
+				print(expr->truth_value);
+				print(")");
+			}
+
+			void print(const box<BetweenPred>& expr) {
+				print("(");
+				print(expr->val);
+				print(expr->symmetric ? " BETWEEN SYMMETRIC " : " BETWEEN ");
+				print(expr->low);
+				print(" AND ");
+				print(expr->high);
+				print(")");
+			}
+
+			// a list of values is kept as a bare ValuesExpr, a subquery as a Query
+			void print(const box<InPred>& expr) {
+				print("(");
+				print(expr->val);
+				print(" IN ");
+				if (auto values = std::get_if<box<ValuesExpr>>(&expr->rows)) {
+					print("(");
+					list((*values)->rows, [&](const Expression& e) { print(e); });
+					print(")");
+				} else {
+					table(expr->rows);
+				}
+				print(")");
+			}
+
+			void print(const box<LikePred>& expr) {
+				print("(");
+				print(expr->val);
+				print(" LIKE ");
+				print(expr->pattern);
+				if (expr->escape.has_value()) {
+					print(" ESCAPE ");
+					print(*expr->escape);
+				}
+				print(")");
+			}
+
+			void print(const box<ExistsPred>& expr) {
+				print("(EXISTS ");
+				subquery(*expr->subquery);
+				print(")");
+			}
+
+			void print(const box<UniquePred>& expr) {
+				print("(UNIQUE ");
+				subquery(*expr->subquery);
+				print(")");
+			}
+
+			void print(const box<AggregateExpr>& expr) {
+				using enum AggregateExpr::Op;
+				switch (expr->op) {
+					case AVG:
+						print("AVG(");
+						break;
+					case MAX:
+						print("MAX(");
+						break;
+					case MIN:
+						print("MIN(");
+						break;
+					case SUM:
+						print("SUM(");
+						break;
+					case COUNT:
+						print("COUNT(");
+						break;
+					case EVERY:
+						print("EVERY(");
+						break;
+					case ANY:
+						print("ANY(");
+						break;
+					case SOME:
+						print("SOME(");
+						break;
+					case STDDEV_POP:
+						print("STDDEV_POP(");
+						break;
+					case STDDEV_SAMP:
+						print("STDDEV_SAMP(");
+						break;
+					case VAR_POP:
+						print("VAR_POP(");
+						break;
+					case VAR_SAMP:
+						print("VAR_SAMP(");
+						break;
+					case COLLECT:
+						print("COLLECT(");
+						break;
+					case FUSION:
+						print("FUSION(");
+						break;
+					case INTERSECTION:
+						print("INTERSECTION(");
+						break;
+				}
+				if (expr->quantifier.has_value()) {
+					print(*expr->quantifier);
+					print(" ");
+				}
+				print(expr->argument);
+				print(")");
+				if (expr->filter.has_value()) {
+					print(" FILTER (WHERE ");
+					print(*expr->filter);
+					print(")");
+				}
+			}
+		};
+	}
+
+	namespace {
+		// kept from one call to the next, so deparsing stops allocating once it has seen the deepest tree
+		thread_local deparser::stack work;
+	}
+
+	void deparse(const Statement& stmt, std::string& out) {
+		deparser d { out, work };
+		work.run(d, &deparser::step<Statement, &deparser::print>, &stmt);
+	}
+
+	void deparse(const Expression& expr, std::string& out) {
+		deparser d { out, work };
+		work.run(d, &deparser::step<Expression, &deparser::visitExpression>, &expr);
+	}
+
+	void deparse(const RelExpression& expr, std::string& out) {
+		deparser d { out, work };
+		if (auto query = std::get_if<box<Query>>(&expr)) {
+			work.run(d, &deparser::step<Query, &deparser::query>, &**query);
+		} else {
+			work.run(d, &deparser::step<RelExpression, &deparser::visitBody>, &expr);
+		}
+	}
+
+	std::string deparse(const Statement& stmt) {
+		std::string out;
+		deparse(stmt, out);
+		return out;
+	}
+}
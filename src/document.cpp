@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <iterator>
+
+#include "psql_parse/document.hpp"
+
+namespace psql_parse {
+
+	Document::Document(std::string_view text)
+	: driver_()
+	, segments_()
+	, starts_()
+	, valid_(1)
+	, reparsed_(0) {
+		driver_.recoverErrors(true);
+		segments_ = parse(text, 0, [](std::size_t) { return true; });
+		starts_.resize(segments_.size());
+		starts_[0] = Position { 0, 1, 1 };
+		reparsed_ = segments_.size();
+	}
+
+	std::vector<Document::Segment> Document::parse(std::string_view text, std::size_t begin,
+												   const std::function<bool(std::size_t)>& more) {
+		std::vector<Segment> parsed;
+		Segment current {};
+		// input offset of the start of current, and diagnostics handed out
+		std::size_t from = 0;
+		std::size_t reported = 0;
+		bool stopped = false;
+
+		auto close = [&](std::size_t to) {
+			auto source = text.substr(begin + from, to - from);
+			current.length = source.size();
+			current.lines = static_cast<position::counter_type>(std::count(source.begin(), source.end(), '\n'));
+			auto newline = source.rfind('\n');
+			current.tail = newline == std::string_view::npos ? source.size() : source.size() - newline - 1;
+
+			auto& diagnostics = driver_.diagnostics();
+			current.diagnostics.assign(diagnostics.begin() + static_cast<std::ptrdiff_t>(reported), diagnostics.end());
+			reported = diagnostics.size();
+
+			parsed.push_back(std::move(current));
+			current = Segment {};
+			from = to;
+		};
+
+		driver_.on_boundary_ = [&](std::size_t offset) {
+			close(offset);
+			stopped = !more(begin + offset);
+			return !stopped;
+		};
+		driver_.parseScript(text.substr(begin), [&](Statement& stmt) {
+			current.statement = std::move(stmt);
+		});
+		driver_.on_boundary_ = nullptr;
+
+		if (!stopped) {
+			close(text.size() - begin);
+		}
+		return parsed;
+	}
+
+	void Document::edit(std::size_t offset, std::size_t removed, std::string_view inserted, std::string_view text) {
+		// Everything before the segment the edit begins in is unchanged
+		auto first = segmentAt(offset);
+		auto begin = start(first).offset;
+		auto edited = offset + inserted.size();
+
+		// Old segments [first, last) are replaced, last starting at old_end
+		auto last = first;
+		auto old_end = begin;
+		bool reused = false;
+		auto parsed = parse(text, begin, [&](std::size_t end) {
+			if (end <= edited) {
+				return true;
+			}
+			// past the edit, where this ';' was before it
+			auto old = end - inserted.size() + removed;
+			while (last < segments_.size() && old_end < old) {
+				old_end += segments_[last++].length;
+			}
+			reused = old_end == old;
+			return !reused;
+		});
+		if (!reused) {
+			last = segments_.size();
+		}
+
+		auto at = segments_.erase(segments_.begin() + static_cast<std::ptrdiff_t>(first),
+								  segments_.begin() + static_cast<std::ptrdiff_t>(last));
+		segments_.insert(at, std::make_move_iterator(parsed.begin()), std::make_move_iterator(parsed.end()));
+
+		// Starts up to first have not moved, the rest move when asked for
+		starts_.resize(segments_.size());
+		valid_ = std::min(valid_, first + 1);
+		reparsed_ = parsed.size();
+	}
+
+	const Statement* Document::statement(std::size_t segment) const {
+		auto& statement = segments_[segment].statement;
+		return statement ? &*statement : nullptr;
+	}
+
+	const std::vector<Diagnostic>& Document::diagnostics(std::size_t segment) const {
+		return segments_[segment].diagnostics;
+	}
+
+	Document::Position Document::start(std::size_t segment) const {
+		for (; valid_ <= segment; valid_++) {
+			auto& previous = segments_[valid_ - 1];
+			auto next = starts_[valid_ - 1];
+			next.offset += previous.length;
+			if (previous.lines > 0) {
+				next.line += previous.lines;
+				next.column = static_cast<position::counter_type>(previous.tail + 1);
+			} else {
+				next.column += static_cast<position::counter_type>(previous.tail);
+			}
+			starts_[valid_] = next;
+		}
+		return starts_[segment];
+	}
+
+	std::size_t Document::segmentAt(std::size_t offset) const {
+		if (starts_[valid_ - 1].offset > offset) {
+			auto after = std::upper_bound(starts_.begin(), starts_.begin() + static_cast<std::ptrdiff_t>(valid_), offset,
+										  [](std::size_t offset, const Position& start) { return offset < start.offset; });
+			return static_cast<std::size_t>(after - starts_.begin()) - 1;
+		}
+		auto segment = valid_ - 1;
+		while (segment + 1 < segments_.size() && start(segment + 1).offset <= offset) {
+			segment++;
+		}
+		return segment;
+	}
+
+	location Document::locate(std::size_t segment, const location& loc) const {
+		auto base = start(segment);
+		auto place = [&](position pos) {
+			if (pos.line == 1) {
+				pos.column += base.column - 1;
+			}
+			pos.line += base.line - 1;
+			return pos;
+		};
+		return location(place(loc.begin), place(loc.end));
+	}
+}
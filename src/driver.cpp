@@ -1,30 +1,334 @@
+#include <algorithm>
+#include <chrono>
+
 #include "psql_parse/driver.hpp"
 
 psql_parse::driver::driver()
 : scanner_(nullptr)
+, parser_(nullptr)
 , trace_scanning_(false)
 , trace_parsing_(false)
 , scanner_err_(std::cerr)
-, result_() { }
+, use_arena_(false)
+, arena_()
+, result_()
+, on_statement_(nullptr)
+, statements_(0)
+, on_rows_()
+, row_batch_(0)
+, rows_()
+, rows_mark_()
+, insert_table_(nullptr)
+, depth_(0)
+, values_depth_(0)
+, values_lists_(0)
+, streamed_list_(0)
+, streamed_(false)
+, stats_()
+, collector_(nullptr)
+, sampled_ns_(0)
+, samples_(0)
+, on_boundary_()
+, at_boundary_(false)
+, recover_(false)
+, diagnostics_() {
+    nf.setStats(&stats_);
+}
 
 bool psql_parse::driver::parse(std::istream &in) {
+    attach(in);
+    return run(nullptr);
+}
+
+bool psql_parse::driver::parse(std::string_view input) {
+    attach(input);
+    return run(nullptr);
+}
+
+bool psql_parse::driver::parseScript(std::istream &in, const StatementCallback &callback) {
+    attach(in);
+    return run(&callback);
+}
+
+bool psql_parse::driver::parseScript(std::string_view input, const StatementCallback &callback) {
+    attach(input);
+    return run(&callback);
+}
+
+void psql_parse::driver::attach(std::istream &in) {
     if (scanner_ == nullptr) {
-        scanner_ = std::make_unique<scanner>(&in);
-    } else {
-        scanner_->reset();
-        scanner_->switch_streams(in, scanner_err_);
+        scanner_ = std::make_unique<scanner>(&in, &scanner_err_);
     }
+    scanner_->reset(in);
+}
+
+void psql_parse::driver::attach(std::string_view input) {
+    if (scanner_ == nullptr) {
+        scanner_ = std::make_unique<scanner>(nullptr, &scanner_err_);
+    }
+    scanner_->reset(input);
+}
+
+bool psql_parse::driver::run(const StatementCallback *on_statement) {
     scanner_->set_debug(trace_scanning_);
-    parser p(*this);
-    p.set_debug_level(trace_parsing_);
-	nf.clear();
-    return p.parse() == 0;
+    if (parser_ == nullptr) {
+        parser_ = std::make_unique<parser>(*this);
+    }
+    parser_->set_debug_level(trace_parsing_);
+
+    // Drop the previous tree (and rows left by a failed parse) before
+    // their memory is reused
+    result_ = Statement();
+    rows_.clear();
+    if (use_arena_) {
+        arena_.reset();
+    }
+
+    on_statement_ = on_statement;
+    statements_ = 0;
+    diagnostics_.clear();
+    insert_table_ = nullptr;
+    depth_ = 0;
+    values_lists_ = 0;
+    streamed_list_ = 0;
+    streamed_ = false;
+    at_boundary_ = false;
+#ifdef PSQL_PARSE_STATS
+    stats_ = ParseStats();
+    sampled_ns_ = 0;
+    samples_ = 0;
+    auto start = std::chrono::steady_clock::now();
+#endif
+    bool success;
+    {
+        // Lists in the tree are allocated where its nodes are
+        ArenaScope scope(use_arena_ ? &arena_ : nullptr);
+        success = parser_->parse() == 0 && diagnostics_.empty();
+    }
+    on_statement_ = nullptr;
+#ifdef PSQL_PARSE_STATS
+    stats_.total_ns = static_cast<std::uint64_t>(std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count());
+    stats_.scan_ns = samples_ == 0 ? 0 : sampled_ns_ * stats_.tokens / samples_;
+    stats_.arena_bytes += use_arena_ ? arena_.bytesUsed() : 0;
+    if (collector_ != nullptr) {
+        collector_->add(stats_);
+    }
+#endif
+
+    if (success && on_statement == nullptr && statements_ == 0) {
+        error(location(), "syntax error, expected a statement");
+        return false;
+    }
+    return success;
+}
+
+void psql_parse::driver::emit(Statement stmt, const location &loc) {
+    statements_++;
+
+    if (streamed_) {
+        auto insert = std::get_if<box<InsertStatement>>(&stmt);
+        auto query = insert == nullptr ? nullptr : std::get_if<box<Query>>(&(*insert)->source);
+        if (query == nullptr || !std::holds_alternative<box<ValuesExpr>>((*query)->expr)
+            || !(*query)->order.empty() || (*query)->offset.has_value() || (*query)->fetch.has_value()) {
+            throw parser::syntax_error(loc, "syntax error, streamed VALUES must be the whole INSERT source");
+        }
+        streamed_ = false;
+    }
+    insert_table_ = nullptr;
+
+    if (on_statement_ == nullptr) {
+        if (statements_ > 1) {
+            throw parser::syntax_error(loc, "syntax error, expected a single statement");
+        }
+        result_ = std::move(stmt);
+        return;
+    }
+
+    {
+        // whatever the callback builds outlives the arena
+        ArenaScope scope(nullptr);
+        (*on_statement_)(stmt);
+    }
+
+    // Destroy the statement before its arena memory is handed out again
+    stmt = Statement();
+    if (use_arena_) {
+#ifdef PSQL_PARSE_STATS
+        stats_.arena_bytes += arena_.bytesUsed();
+#endif
+        arena_.reset();
+    }
+}
+
+psql_parse::parser::symbol_type psql_parse::driver::lex([[maybe_unused]] std::size_t stack_depth) {
+    // Deferred from the ';' itself: by now the statement before it has
+    // been emitted, or its syntax error recorded
+    if (at_boundary_) {
+        at_boundary_ = false;
+        scanner_->restartLocation();
+        if (!on_boundary_(scanner_->offset())) {
+            return parser::make_END(location());
+        }
+    }
+#ifdef PSQL_PARSE_STATS
+    stats_.max_stack_depth = std::max<std::uint64_t>(stats_.max_stack_depth, stack_depth);
+    auto token = stats_.tokens++ % 64 == 0 ? timedLex() : scanner_->lex();
+#else
+    auto token = scanner_->lex();
+#endif
+    if (on_rows_) {
+        switch (token.kind()) {
+            case parser::symbol_kind::S_LP:
+                depth_++;
+                break;
+            case parser::symbol_kind::S_RP:
+                depth_--;
+                break;
+            case parser::symbol_kind::S_VALUES:
+                values_depth_ = depth_;
+                break;
+            case parser::symbol_kind::S_SEMICOLON:
+                // tokens skipped after a syntax error may be unbalanced
+                depth_ = 0;
+                break;
+            default:
+                break;
+        }
+    }
+    if (on_boundary_ && token.kind() == parser::symbol_kind::S_SEMICOLON) {
+        at_boundary_ = true;
+    }
+    return token;
+}
+
+psql_parse::parser::symbol_type psql_parse::driver::timedLex() {
+    auto start = std::chrono::steady_clock::now();
+    auto token = scanner_->lex();
+    sampled_ns_ += static_cast<std::uint64_t>(std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count());
+    samples_++;
+    return token;
 }
 
-[[maybe_unused]] void psql_parse::driver::error(const psql_parse::location &loc, const std::string &message) {
-    std::cerr << loc << " " << message << std::endl;
+void psql_parse::driver::beginInsert(const QualifiedName &table) {
+    insert_table_ = &table;
+}
+
+void psql_parse::driver::beginValues(const location &loc) {
+    values_lists_++;
+
+    // Statements start outside of any parentheses, so a VALUES at depth
+    // zero of an INSERT is (part of) its source and not in a subquery
+    if (!on_rows_ || insert_table_ == nullptr || values_depth_ != 0) {
+        return;
+    }
+    if (streamed_) {
+        throw parser::syntax_error(loc, "syntax error, streamed VALUES must be the whole INSERT source");
+    }
+    streamed_ = true;
+    streamed_list_ = values_lists_;
+    rows_mark_ = arena_.mark();
+}
+
+void psql_parse::driver::addRow(List<Expression> &rows, Expression row) {
+    if (values_lists_ != streamed_list_) {
+        rows.push_back(std::move(row));
+        return;
+    }
+
+    rows_.push_back(std::move(row));
+    if (rows_.size() >= row_batch_) {
+        flushRows();
+    }
+}
+
+psql_parse::List<psql_parse::Expression> psql_parse::driver::endValues(List<Expression> rows) {
+    if (values_lists_ == streamed_list_) {
+        if (!rows_.empty()) {
+            flushRows();
+        }
+        streamed_list_ = 0;
+    }
+    values_lists_--;
+    return rows;
+}
+
+void psql_parse::driver::flushRows() {
+    {
+        ArenaScope scope(nullptr);
+        on_rows_(*insert_table_, rows_);
+    }
+
+    // Only the batch has been allocated since the mark, the rows are
+    // destroyed before their arena memory is handed out again
+    rows_.clear();
+    if (use_arena_) {
+#ifdef PSQL_PARSE_STATS
+        stats_.arena_bytes += arena_.bytesUsed() - rows_mark_.used;
+#endif
+        arena_.rewind(rows_mark_);
+    }
+}
+
+void psql_parse::driver::error(const psql_parse::location &loc, const std::string &message) {
+    if (!recover_) {
+        std::cerr << loc << " " << message << std::endl;
+    }
+    diagnostics_.push_back({ loc, message });
+}
+
+bool psql_parse::driver::resync() {
+    // Forget what the broken statement left behind
+    rows_.clear();
+    insert_table_ = nullptr;
+    values_lists_ = 0;
+    streamed_list_ = 0;
+    streamed_ = false;
+    return recover_;
 }
 
 psql_parse::Statement& psql_parse::driver::getResult() {
     return result_;
 }
+
+void psql_parse::driver::useArena(bool enable) {
+    result_ = Statement();
+    use_arena_ = enable;
+    nf.setArena(enable ? &arena_ : nullptr);
+}
+
+void psql_parse::driver::streamRows(RowsCallback callback, std::size_t batch_size) {
+    on_rows_ = std::move(callback);
+    row_batch_ = batch_size == 0 ? 1 : batch_size;
+}
+
+void psql_parse::driver::recoverErrors(bool enable) {
+    recover_ = enable;
+}
+
+const std::vector<psql_parse::Diagnostic>& psql_parse::driver::diagnostics() const {
+    return diagnostics_;
+}
+
+const psql_parse::ParseStats& psql_parse::driver::stats() const {
+    return stats_;
+}
+
+void psql_parse::driver::collectStats(StatsCollector *collector) {
+    collector_ = collector;
+}
+
+std::size_t psql_parse::driver::bytesReserved() const {
+    return arena_.bytesReserved() + (scanner_ == nullptr ? 0 : scanner_->bytesReserved());
+}
+
+void psql_parse::driver::trim(std::size_t bytes) {
+    result_ = Statement();
+    rows_ = std::vector<Expression>();
+    if (scanner_ != nullptr) {
+        scanner_->trim(bytes);
+        bytes -= std::min(bytes, scanner_->bytesReserved());
+    }
+    arena_.reset();
+    arena_.trim(bytes);
+    parser_ = nullptr;
+}
@@ -0,0 +1,388 @@
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "psql_parse/fingerprint.hpp"
+#include "psql_parse/visit.hpp"
+
+namespace psql_parse {
+
+	namespace {
+		/*
+		 * Part of the hash: only ever append, never reorder, or every
+		 * stored fingerprint changes.
+		 */
+		enum class Kind : std::uint64_t {
+			CREATE_STATEMENT = 1,
+			INSERT_STATEMENT,
+			DELETE_STATEMENT,
+			SELECT_STATEMENT,
+			JOIN_EXPR,
+			TABLE_NAME,
+			TABLE_ALIAS,
+			SELECT_EXPR,
+			VALUES_EXPR,
+			SET_OP,
+			QUERY,
+			WITH_CLAUSE,
+			WITH_SPEC,
+			ALIAS_EXPR,
+			ASTERISK,
+			INTEGER_LITERAL,
+			FLOAT_LITERAL,
+			STRING_LITERAL,
+			BOOLEAN_LITERAL,
+			UNARY_OP,
+			BINARY_OP,
+			ROW_EXPR,
+			ROW_SUBQUERY,
+			VAR,
+			COLLATE,
+			IS_EXPR,
+			BETWEEN_PRED,
+			IN_PRED,
+			LIKE_PRED,
+			EXISTS_PRED,
+			UNIQUE_PRED,
+			SORT_SPEC,
+			GROUPING_SET,
+			GROUPING_SETS,
+			ROLLUP,
+			CUBE,
+			AGGREGATE_EXPR,
+			WINDOW,
+			PARAM
+		};
+
+		struct fingerprinter {
+			std::uint64_t hash = 0xcbf29ce484222325;
+			default_visit<fingerprinter> walker { *this };
+
+			void mix(std::uint64_t value) {
+				hash = ((hash << 5) | (hash >> 59)) ^ value;
+				hash *= 0x9e3779b97f4a7c15;
+			}
+
+			void mix(Kind kind) {
+				mix(static_cast<std::uint64_t>(kind));
+			}
+
+			void mix(bool value) {
+				mix(static_cast<std::uint64_t>(value));
+			}
+
+			void mix(const Name& name) {
+				mix(static_cast<std::uint64_t>(name.hash()));
+			}
+
+			void mix(const List<Name>& names) {
+				mix(static_cast<std::uint64_t>(names.size()));
+				for (auto& name : names)
+					mix(name);
+			}
+
+			void mix(const QualifiedName& name) {
+				mix(name.qualifier);
+				mix(name.name);
+			}
+
+			template <class E>
+			requires std::is_enum_v<E>
+			void mix(E value) {
+				mix(static_cast<std::uint64_t>(value));
+			}
+
+			template <class V>
+			void mix(const std::optional<V>& value) {
+				mix(value.has_value());
+				if (value.has_value())
+					mix(value.value());
+			}
+
+			// Only the presence of a child, the child itself is visited
+			template <class V>
+			void present(const std::optional<V>& value) {
+				mix(value.has_value());
+			}
+
+			template <class V>
+			void count(const List<V>& values) {
+				mix(static_cast<std::uint64_t>(values.size()));
+			}
+
+			std::uint64_t finish() {
+				// splitmix64 finalizer, spreads the last few mixes over all bits
+				auto h = hash;
+				h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9;
+				h = (h ^ (h >> 27)) * 0x94d049bb133111eb;
+				return h ^ (h >> 31);
+			}
+
+			void enter(box<CreateStatement>& stmt) {
+				mix(Kind::CREATE_STATEMENT);
+				mix(*stmt->rel_name);
+				mix(stmt->temp);
+				mix(stmt->on_commit);
+				count(stmt->column_defs);
+				for (auto& def : stmt->column_defs) {
+					mix(def.name);
+					mix(static_cast<std::uint64_t>(def.type.index()));
+					present(def.col_default);
+					count(def.col_constraint);
+				}
+				count(stmt->table_constraints);
+				for (auto& constraint : stmt->table_constraints) {
+					mix(static_cast<std::uint64_t>(constraint.index()));
+					std::visit([this](auto& c) { mix(c.column_names); }, constraint);
+				}
+			}
+
+			void enter(box<InsertStatement>& stmt) {
+				mix(Kind::INSERT_STATEMENT);
+				mix(*stmt->table_name);
+				mix(stmt->column_names);
+				mix(stmt->override);
+				mix(static_cast<std::uint64_t>(stmt->source.index()));
+			}
+
+			void enter(box<DeleteStatement>& stmt) {
+				mix(Kind::DELETE_STATEMENT);
+				mix(*stmt->table_name);
+				mix(stmt->only);
+				present(stmt->where);
+			}
+
+			void enter(box<SelectStatement>&) {
+				mix(Kind::SELECT_STATEMENT);
+			}
+
+			void enter(box<JoinExpr>& expr) {
+				mix(Kind::JOIN_EXPR);
+				mix(expr->kind);
+				mix(expr->natural);
+				present(expr->qualifier);
+				mix(expr->columns);
+			}
+
+			void enter(box<TableName>& expr) {
+				mix(Kind::TABLE_NAME);
+				mix(*expr->name);
+			}
+
+			void enter(box<TableAlias>& expr) {
+				mix(Kind::TABLE_ALIAS);
+				mix(expr->name);
+				mix(expr->columns);
+			}
+
+			void enter(box<SelectExpr>& expr) {
+				mix(Kind::SELECT_EXPR);
+				count(expr->target_list);
+				count(expr->from_clause);
+				present(expr->where_clause);
+				present(expr->group_clause);
+				if (expr->group_clause.has_value()) {
+					mix(expr->group_clause->group_quantifier);
+					count(expr->group_clause->group_clause);
+				}
+				present(expr->having_clause);
+				count(expr->window_clause);
+				mix(expr->set_quantifier);
+			}
+
+			void enter(box<ValuesExpr>& expr) {
+				mix(Kind::VALUES_EXPR);
+				count(expr->rows);
+			}
+
+			void enter(box<SetOp>& expr) {
+				mix(Kind::SET_OP);
+				mix(expr->op);
+				mix(expr->quantifier);
+			}
+
+			void enter(box<Query>& expr) {
+				mix(Kind::QUERY);
+				present(expr->with);
+				count(expr->order);
+				present(expr->offset);
+				present(expr->fetch);
+				if (expr->fetch.has_value()) {
+					mix(expr->fetch->kind);
+					mix(expr->fetch->with_ties);
+					mix(expr->fetch->percent);
+					present(expr->fetch->value);
+				}
+			}
+
+			void enter(box<WithClause>& expr) {
+				mix(Kind::WITH_CLAUSE);
+				mix(expr->recursive);
+				count(expr->elements);
+			}
+
+			void enter(box<WithSpec>& expr) {
+				mix(Kind::WITH_SPEC);
+				mix(expr->name);
+				mix(expr->columns);
+			}
+
+			void enter(box<AliasExpr>& expr) {
+				mix(Kind::ALIAS_EXPR);
+				mix(expr->name);
+			}
+
+			void enter(box<Asterisk>&) {
+				mix(Kind::ASTERISK);
+			}
+
+			/* Literals: the kind counts, the value does not */
+			void enter(box<IntegerLiteral>&) {
+				mix(Kind::INTEGER_LITERAL);
+			}
+
+			void enter(box<FloatLiteral>&) {
+				mix(Kind::FLOAT_LITERAL);
+			}
+
+			void enter(box<StringLiteral>& expr) {
+				mix(Kind::STRING_LITERAL);
+				mix(expr->type);
+			}
+
+			void enter(box<BooleanLiteral>&) {
+				mix(Kind::BOOLEAN_LITERAL);
+			}
+
+			/* Like a literal, $1 and $2 are both just a value */
+			void enter(box<Param>&) {
+				mix(Kind::PARAM);
+			}
+
+			void enter(box<UnaryOp>& expr) {
+				mix(Kind::UNARY_OP);
+				mix(expr->op);
+			}
+
+			void enter(box<BinaryOp>& expr) {
+				mix(Kind::BINARY_OP);
+				mix(expr->op);
+			}
+
+			void enter(box<RowExpr>& expr) {
+				mix(Kind::ROW_EXPR);
+				count(expr->exprs);
+			}
+
+			void enter(box<RowSubquery>&) {
+				mix(Kind::ROW_SUBQUERY);
+			}
+
+			void enter(box<Var>& expr) {
+				mix(Kind::VAR);
+				mix(expr->name);
+			}
+
+			void enter(box<Collate>& expr) {
+				mix(Kind::COLLATE);
+				mix(*expr->collation);
+			}
+
+			void enter(box<IsExpr>& expr) {
+				// IS [NOT] TRUE / FALSE / UNKNOWN is syntax, not a parameter
+				mix(Kind::IS_EXPR);
+				mix(expr->truth_value->value);
+			}
+
+			void enter(box<BetweenPred>& expr) {
+				mix(Kind::BETWEEN_PRED);
+				mix(expr->symmetric);
+			}
+
+			void enter(box<InPred>&) {
+				mix(Kind::IN_PRED);
+			}
+
+			void enter(box<LikePred>& expr) {
+				mix(Kind::LIKE_PRED);
+				present(expr->escape);
+			}
+
+			void enter(box<ExistsPred>&) {
+				mix(Kind::EXISTS_PRED);
+			}
+
+			void enter(box<UniquePred>&) {
+				mix(Kind::UNIQUE_PRED);
+			}
+
+			void enter(box<SortSpec>& expr) {
+				mix(Kind::SORT_SPEC);
+				mix(expr->order);
+				mix(expr->null_order);
+			}
+
+			void enter(box<GroupingSet>& expr) {
+				mix(Kind::GROUPING_SET);
+				count(expr->columns);
+			}
+
+			void enter(box<GroupingSets>& expr) {
+				mix(Kind::GROUPING_SETS);
+				count(expr->sets);
+			}
+
+			void enter(box<Rollup>& expr) {
+				mix(Kind::ROLLUP);
+				count(expr->sets);
+			}
+
+			void enter(box<Cube>& expr) {
+				mix(Kind::CUBE);
+				count(expr->sets);
+			}
+
+			void enter(box<AggregateExpr>& expr) {
+				mix(Kind::AGGREGATE_EXPR);
+				mix(expr->op);
+				mix(expr->quantifier);
+				present(expr->filter);
+			}
+
+			void enter(box<Window>& expr) {
+				mix(Kind::WINDOW);
+				mix(expr->window_name);
+				mix(expr->existing_window);
+				count(expr->partition);
+				count(expr->sort);
+				present(expr->frame);
+				if (expr->frame.has_value()) {
+					mix(expr->frame->unit);
+					mix(expr->frame->start.first);
+					present(expr->frame->end);
+					if (expr->frame->end.has_value())
+						mix(expr->frame->end->first);
+					mix(expr->frame->exclude);
+				}
+			}
+		};
+	}
+
+	std::uint64_t fingerprint(Statement& stmt) {
+		fingerprinter f;
+		f.walker.visit(stmt);
+		return f.finish();
+	}
+
+	std::uint64_t fingerprint(Expression& expr) {
+		fingerprinter f;
+		f.walker.visit(expr);
+		return f.finish();
+	}
+
+	std::uint64_t fingerprint(RelExpression& expr) {
+		fingerprinter f;
+		f.walker.visit(expr);
+		return f.finish();
+	}
+}
@@ -0,0 +1,470 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include "psql_parse/flat.hpp"
+
+namespace psql_parse {
+
+	namespace flat_detail {
+		/* Flattening leaves these alone: their flat form is the type itself */
+		template <class X>
+		concept Plain = std::is_same_v<FlatOf<X>, X>;
+
+		template <class Pool>
+		std::uint32_t checkedSize(const Pool& pool, std::size_t added) {
+			if (pool.size() + added >= Ref<int>::NONE) {
+				throw std::length_error("flat tree pool exceeds 32-bit indices");
+			}
+			return static_cast<std::uint32_t>(pool.size());
+		}
+
+		/*
+		 * Nodes are appended in pre-order: a node's slot is taken before
+		 * its children are flattened, and a vector's elements are given
+		 * consecutive slots before any of them is.
+		 */
+		struct Flattener {
+			FlatTree& tree;
+
+			template <class X> requires Plain<X>
+			X encode(const X& value) {
+				return value;
+			}
+
+			Text encode(std::string_view value) {
+				Text text { checkedSize(tree.text_, value.size()), static_cast<std::uint32_t>(value.size()) };
+				tree.text_.append(value);
+				return text;
+			}
+
+			Text encode(const std::string& value) {
+				return encode(std::string_view(value));
+			}
+
+			Text encode(const Symbol& value) {
+				return encode(value.str());
+			}
+
+			template <class T>
+			Ref<T> encode(const box<T>& node) {
+				if (node.operator->() == nullptr) {
+					return {};
+				}
+				auto& pool = tree.nodePool<T>();
+				Ref<T> ref { checkedSize(pool, 1) };
+				pool.emplace_back();
+				auto flat = encode(*node);
+				pool[ref.index] = flat;
+				return ref;
+			}
+
+			template <class X>
+			Span<X> encode(const List<X>& values) {
+				auto& pool = tree.spanPool<X>();
+				Span<X> span { checkedSize(pool, values.size()), static_cast<std::uint32_t>(values.size()) };
+				pool.resize(pool.size() + values.size());
+				for (std::uint32_t i = 0; i < span.size; i++) {
+					auto flat = encode(values[i]);
+					pool[span.offset + i] = flat;
+				}
+				return span;
+			}
+
+			template <class X> requires (!Plain<std::optional<X>>)
+			FlatOf<std::optional<X>> encode(const std::optional<X>& value) {
+				if (!value.has_value()) {
+					return std::nullopt;
+				}
+				return encode(*value);
+			}
+
+			template <class... Ts> requires (!Plain<std::variant<Ts...>>)
+			FlatOf<std::variant<Ts...>> encode(const std::variant<Ts...>& value) {
+				FlatOf<std::variant<Ts...>> flat;
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					((value.index() == I ? void(flat.template emplace<I>(encode(std::get<I>(value)))) : void()), ...);
+				}(std::index_sequence_for<Ts...>());
+				return flat;
+			}
+
+			template <class A, class B>
+			FlatOf<std::pair<A, B>> encode(const std::pair<A, B>& value) {
+				FlatOf<std::pair<A, B>> flat;
+				flat.first = encode(value.first);
+				flat.second = encode(value.second);
+				return flat;
+			}
+
+			template <Reflected S>
+			Flat<S> encode(const S& value) {
+				Flat<S> flat;
+				if constexpr (std::derived_from<S, Node>) {
+					flat.loc = {
+						static_cast<std::uint32_t>(value.loc.begin.line), static_cast<std::uint32_t>(value.loc.begin.column),
+						static_cast<std::uint32_t>(value.loc.end.line), static_cast<std::uint32_t>(value.loc.end.column)
+					};
+				}
+				auto members = value.members();
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					((field<I>(flat) = encode(std::get<I>(members))), ...);
+				}(std::make_index_sequence<memberCount<S>>());
+				return flat;
+			}
+		};
+
+		struct Expander {
+			const FlatView& tree;
+			Arena* arena;
+
+			template <class X> requires Plain<X>
+			void decode(const X& flat, X& out) {
+				out = flat;
+			}
+
+			void decode(Text flat, std::string& out) {
+				out = tree[flat];
+			}
+
+			void decode(Text flat, Symbol& out) {
+				out = Symbol(tree[flat]);
+			}
+
+			template <class T>
+			void decode(Ref<T> flat, box<T>& out) {
+				if (!flat) {
+					out = box<T>();
+					return;
+				}
+				T* node = arena == nullptr ? new T() : arena->make<T>();
+				out = box<T>(node, arena == nullptr ? Ownership::HEAP : Ownership::ARENA);
+				decode(tree[flat], *node);
+			}
+
+			template <class X>
+			void decode(Span<X> flat, List<X>& out) {
+				auto elements = tree[flat];
+				out.resize(elements.size());
+				for (std::size_t i = 0; i < elements.size(); i++) {
+					decode(elements[i], out[i]);
+				}
+			}
+
+			template <class X> requires (!Plain<std::optional<X>>)
+			void decode(const FlatOf<std::optional<X>>& flat, std::optional<X>& out) {
+				if (!flat.has_value()) {
+					out.reset();
+					return;
+				}
+				decode(*flat, out.emplace());
+			}
+
+			template <class... Ts> requires (!Plain<std::variant<Ts...>>)
+			void decode(const FlatOf<std::variant<Ts...>>& flat, std::variant<Ts...>& out) {
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					((flat.index() == I ? decode(std::get<I>(flat), out.template emplace<I>()) : void()), ...);
+				}(std::index_sequence_for<Ts...>());
+			}
+
+			template <class A, class B>
+			void decode(const FlatOf<std::pair<A, B>>& flat, std::pair<A, B>& out) {
+				decode(flat.first, out.first);
+				decode(flat.second, out.second);
+			}
+
+			template <Reflected S>
+			void decode(const Flat<S>& flat, S& out) {
+				if constexpr (std::derived_from<S, Node>) {
+					out.loc = location(
+							position(nullptr, static_cast<int>(flat.loc.begin_line), static_cast<int>(flat.loc.begin_column)),
+							position(nullptr, static_cast<int>(flat.loc.end_line), static_cast<int>(flat.loc.end_column)));
+				}
+				auto members = out.members();
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					(decode(field<I>(flat), std::get<I>(members)), ...);
+				}(std::make_index_sequence<memberCount<S>>());
+			}
+		};
+
+		/* Checks that every handle in a blob stays inside its pool */
+		struct Validator {
+			const FlatView& view;
+			bool valid = true;
+
+			void check(Text text) {
+				valid &= std::uint64_t(text.offset) + text.size <= view.text_.size();
+			}
+
+			template <class T>
+			void check(Ref<T> ref) {
+				valid &= !ref || ref.index < view.nodes<T>().size();
+			}
+
+			template <class X>
+			void check(Span<X> span) {
+				valid &= std::uint64_t(span.offset) + span.size <= std::get<ElementSpan<X>>(view.spans_).size();
+			}
+
+			template <class... Ts>
+			void check(const std::variant<Ts...>& variant) {
+				if (variant.index() >= sizeof...(Ts)) {
+					valid = false;
+					return;
+				}
+				std::visit([&](const auto& alternative) { check(alternative); }, variant);
+			}
+
+			template <class X>
+			void check(const std::optional<X>& optional) {
+				if (optional.has_value()) {
+					check(*optional);
+				}
+			}
+
+			template <class A, class B>
+			void check(const FlatPair<A, B>& pair) {
+				check(pair.first);
+				check(pair.second);
+			}
+
+			template <class S>
+			void check(const Flat<S>& flat) {
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					(check(field<I>(flat)), ...);
+				}(std::make_index_sequence<memberCount<S>>());
+			}
+
+			template <class X>
+			void check(const X&) {}
+
+			bool run() {
+				auto pools = [&](const auto&... pool) {
+					((std::ranges::for_each(pool, [&](const auto& entry) { check(entry); })), ...);
+				};
+				std::apply(pools, view.nodes_);
+				std::apply(pools, view.spans_);
+				check(view.root_);
+				return valid;
+			}
+		};
+
+		/*
+		 * A blob starts with a Header and a PoolEntry for every pool: the
+		 * node pools, the span pools, the text and the root, in that order.
+		 * Offsets are from the start of the blob, and every pool starts at
+		 * a multiple of 8.
+		 */
+		struct Header {
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t byte_order;
+			std::uint64_t size;
+			std::uint32_t pool_count;
+			std::uint32_t reserved;
+		};
+
+		struct PoolEntry {
+			std::uint32_t element_size;
+			std::uint32_t count;
+			std::uint64_t offset;
+		};
+
+		constexpr char MAGIC[8] = { 'P', 'S', 'Q', 'L', 'F', 'L', 'A', 'T' };
+		constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+		constexpr std::size_t ALIGNMENT = 8;
+		constexpr std::size_t POOL_COUNT =
+				std::tuple_size_v<Pools<NodeSpan, FlatNodeTypes>::type>
+				+ std::tuple_size_v<Pools<ElementSpan, FlatSpanTypes>::type> + 2;
+
+		constexpr std::uint64_t aligned(std::uint64_t offset) {
+			return (offset + ALIGNMENT - 1) & ~std::uint64_t(ALIGNMENT - 1);
+		}
+
+		template <class... Ts>
+		constexpr bool trivialNodes(TypeList<Ts...>) {
+			return (std::is_trivially_copyable_v<Flat<Ts>> && ...);
+		}
+
+		template <class... Xs>
+		constexpr bool trivialSpans(TypeList<Xs...>) {
+			return (std::is_trivially_copyable_v<FlatOf<Xs>> && ...);
+		}
+
+		static_assert(trivialNodes(FlatNodeTypes()) && trivialSpans(FlatSpanTypes()),
+				"pools must be copyable with memcpy");
+	}
+
+	void FlatView::write(std::string& out) const {
+		using namespace flat_detail;
+
+		std::array<PoolEntry, POOL_COUNT> table {};
+		std::array<const void*, POOL_COUNT> data {};
+		std::size_t next = 0;
+		std::uint64_t offset = sizeof(Header) + sizeof(table);
+		auto add = [&]<class E>(std::span<const E> pool) {
+			offset = aligned(offset);
+			table[next] = { sizeof(E), static_cast<std::uint32_t>(pool.size()), offset };
+			data[next] = pool.data();
+			offset += pool.size_bytes();
+			next++;
+		};
+		std::apply([&](auto... pool) { (add(pool), ...); }, nodes_);
+		std::apply([&](auto... pool) { (add(pool), ...); }, spans_);
+		add(std::span<const char>(text_));
+		add(std::span<const FlatOf<Statement>>(&root_, 1));
+
+		Header header {};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.version = FORMAT_VERSION;
+		header.byte_order = BYTE_ORDER_MARK;
+		header.size = aligned(offset);
+		header.pool_count = POOL_COUNT;
+
+		std::size_t base = out.size();
+		out.resize(base + header.size, '\0');
+		char* blob = out.data() + base;
+		std::memcpy(blob, &header, sizeof(header));
+		std::memcpy(blob + sizeof(header), table.data(), sizeof(table));
+		for (std::size_t i = 0; i < POOL_COUNT; i++) {
+			if (table[i].count != 0) {
+				std::memcpy(blob + table[i].offset, data[i], std::size_t(table[i].count) * table[i].element_size);
+			}
+		}
+	}
+
+	std::optional<FlatView> FlatView::read(std::string_view& bytes) {
+		using namespace flat_detail;
+
+		Header header;
+		std::array<PoolEntry, POOL_COUNT> table;
+		if (bytes.size() < sizeof(header) + sizeof(table)
+				|| reinterpret_cast<std::uintptr_t>(bytes.data()) % ALIGNMENT != 0) {
+			return std::nullopt;
+		}
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+				|| header.version != FORMAT_VERSION
+				|| header.byte_order != BYTE_ORDER_MARK
+				|| header.pool_count != POOL_COUNT
+				|| header.size > bytes.size()
+				|| header.size < sizeof(header) + sizeof(table)
+				|| header.size % ALIGNMENT != 0) {
+			return std::nullopt;
+		}
+		std::memcpy(table.data(), bytes.data() + sizeof(header), sizeof(table));
+
+		FlatView view;
+		bool valid = true;
+		std::size_t next = 0;
+		auto take = [&]<class E>(std::span<const E>& pool) {
+			const PoolEntry& entry = table[next++];
+			if (entry.element_size != sizeof(E)
+					|| entry.offset % ALIGNMENT != 0
+					|| entry.offset > header.size
+					|| std::uint64_t(entry.count) * sizeof(E) > header.size - entry.offset) {
+				valid = false;
+				return;
+			}
+			pool = { reinterpret_cast<const E*>(bytes.data() + entry.offset), entry.count };
+		};
+		std::apply([&](auto&... pool) { (take(pool), ...); }, view.nodes_);
+		std::apply([&](auto&... pool) { (take(pool), ...); }, view.spans_);
+		std::span<const char> text;
+		std::span<const FlatOf<Statement>> root;
+		take(text);
+		take(root);
+		if (!valid || root.size() != 1) {
+			return std::nullopt;
+		}
+		view.text_ = { text.data(), text.size() };
+		view.root_ = root[0];
+
+		if (!Validator { view }.run()) {
+			return std::nullopt;
+		}
+		bytes.remove_prefix(header.size);
+		return view;
+	}
+
+	Statement FlatView::expand(Arena* arena) const {
+		// Lists go where the nodes go
+		ArenaScope scope(arena);
+		Statement stmt;
+		flat_detail::Expander { *this, arena }.decode(root_, stmt);
+		return stmt;
+	}
+
+	std::size_t FlatView::size() const {
+		return std::apply([](auto&... pool) { return (pool.size() + ...); }, nodes_);
+	}
+
+	FlatTree::FlatTree(const Statement& stmt) {
+		assign(stmt);
+	}
+
+	FlatTree::FlatTree(const FlatTree& other)
+	: nodes_(other.nodes_), spans_(other.spans_), text_(other.text_), view_(other.view_) {
+		refresh();
+	}
+
+	FlatTree::FlatTree(FlatTree&& other) noexcept
+	: nodes_(std::move(other.nodes_)), spans_(std::move(other.spans_)), text_(std::move(other.text_)), view_(other.view_) {
+		refresh();
+		other.clear();
+	}
+
+	FlatTree& FlatTree::operator=(const FlatTree& other) {
+		if (this != &other) {
+			nodes_ = other.nodes_;
+			spans_ = other.spans_;
+			text_ = other.text_;
+			view_ = other.view_;
+			refresh();
+		}
+		return *this;
+	}
+
+	FlatTree& FlatTree::operator=(FlatTree&& other) noexcept {
+		if (this != &other) {
+			nodes_ = std::move(other.nodes_);
+			spans_ = std::move(other.spans_);
+			text_ = std::move(other.text_);
+			view_ = other.view_;
+			refresh();
+			other.clear();
+		}
+		return *this;
+	}
+
+	void FlatTree::refresh() {
+		[&]<std::size_t... I>(std::index_sequence<I...>) {
+			((std::get<I>(view_.nodes_) = std::get<I>(nodes_)), ...);
+		}(std::make_index_sequence<std::tuple_size_v<decltype(nodes_)>>());
+		[&]<std::size_t... I>(std::index_sequence<I...>) {
+			((std::get<I>(view_.spans_) = std::get<I>(spans_)), ...);
+		}(std::make_index_sequence<std::tuple_size_v<decltype(spans_)>>());
+		view_.text_ = text_;
+	}
+
+	void FlatTree::assign(const Statement& stmt) {
+		clear();
+		view_.root_ = flat_detail::Flattener { *this }.encode(stmt);
+		refresh();
+	}
+
+	void FlatTree::clear() {
+		std::apply([](auto&... pool) { (pool.clear(), ...); }, nodes_);
+		std::apply([](auto&... pool) { (pool.clear(), ...); }, spans_);
+		text_.clear();
+		view_.root_ = {};
+		refresh();
+	}
+
+	std::size_t FlatTree::bytes() const {
+		auto sum = [](auto&... pool) {
+			return ((pool.size() * sizeof(typename std::remove_cvref_t<decltype(pool)>::value_type)) + ...);
+		};
+		return std::apply(sum, nodes_) + std::apply(sum, spans_) + text_.size();
+	}
+}
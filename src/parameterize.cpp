@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <utility>
+
+#include "psql_parse/ast/nodes.hpp"
+#include "psql_parse/parameterize.hpp"
+#include "psql_parse/visit.hpp"
+
+namespace psql_parse {
+
+	namespace {
+		struct parameterizer {
+			default_visit<parameterizer> walker { *this };
+			NodeFactory nf;
+
+			std::uint64_t existing = 0;
+			std::vector<Literal> constants;
+			std::vector<Param*> created;
+
+			/* Only sees the params that were there before, new ones are not descended into */
+			void enter(box<Param>& param) {
+				existing = std::max(existing, param->number);
+			}
+
+			void visit(Expression& expr) {
+				if (!replace<IntegerLiteral>(expr) && !replace<FloatLiteral>(expr)
+					&& !replace<StringLiteral>(expr) && !replace<BooleanLiteral>(expr)) {
+					walker.descend(expr);
+				}
+			}
+
+			template <class L>
+			bool replace(Expression& expr) {
+				auto literal = std::get_if<box<L>>(&expr);
+				if (literal == nullptr) {
+					return false;
+				}
+
+				auto param = nf.node<Param>((*literal)->loc, constants.size() + 1);
+				created.push_back(param.operator->());
+				constants.emplace_back(std::move(*literal));
+				expr = std::move(param);
+				return true;
+			}
+		};
+	}
+
+	Parameterized parameterize(Statement stmt, Arena* arena) {
+		parameterizer p;
+		p.nf.setArena(arena);
+		p.walker.visit(stmt);
+
+		// A later $n may have been seen after the first literals were numbered
+		if (p.existing != 0) {
+			for (auto param : p.created) {
+				param->number += p.existing;
+			}
+		}
+
+		return Parameterized { std::move(stmt), p.existing, std::move(p.constants) };
+	}
+}
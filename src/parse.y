@@ -49,7 +49,12 @@ class driver;
 #include "psql_parse/driver.hpp"
 
 #undef yylex
-#define yylex driver.scanner_->lex
+#ifdef PSQL_PARSE_STATS
+// the stack is only reachable from inside parse()
+#define yylex() driver.lex(yystack_.size())
+#else
+#define yylex driver.lex
+#endif
 
 #define mkNode driver.nf.node
 #define mkNotNode driver.nf.notNode
@@ -71,7 +76,8 @@ namespace psql_parse {
 
 %token <uint64_t>	INTEGER_VALUE	"integer_value"
 %token <double>		FLOAT_VALUE	"float_value"
-%token <std::string>	IDENTIFIER	"identifier"
+%token <Name>		IDENTIFIER	"identifier"
+%token <uint64_t>	PARAM		"parameter"
 %token <std::string>	STRING_VALUE	"string"
 %token <std::string>	BIT_VALUE	"bit_string"
 %token <std::string>	HEX_VALUE	"hex_string"
@@ -129,7 +135,7 @@ namespace psql_parse {
 %left LP RP
 %left JOIN CROSS LEFT FULL RIGHT INNER NATURAL
 
-%type <Statement>						pseudo_start
+%type <Statement>						statement
 %type <Expression>						numeric_literal
 %type <Expression>						signed_numeric_literal
 %type <Expression>						unsigned_numeric_literal
@@ -152,26 +158,26 @@ namespace psql_parse {
 %type <std::optional<uint64_t>>					opt_timestamp_precision
 %type <std::optional<uint64_t>>					opt_cardinality_clause
 %type <std::optional<box<QualifiedName>>>			opt_scope_clause
-%type <std::vector<RowType::FieldDef>>				field_def_list
+%type <List<RowType::FieldDef>>					field_def_list
 %type <RowType::FieldDef>					field_def
 
-%type <std::vector<Name>>					identifier_list
+%type <List<Name>>						identifier_list
 %type <box<QualifiedName>>					qualified_name
-%type <std::vector<Name>>					qualifier_list
+%type <List<Name>>						qualifier_list
 %type <std::optional<Temporary>>				opt_temporary
 %type <std::optional<OnCommit>>					opt_on_commit
-%type <std::vector<std::variant<ColumnDef, TableConstraint>>>	column_defs_and_constraints
+%type <List<std::variant<ColumnDef, TableConstraint>>>		column_defs_and_constraints
 %type <std::variant<ColumnDef, TableConstraint>>		column_def_and_constraint
 %type <ColumnDef>						column_def
 %type <std::optional<ColumnDefault>>				opt_default_clause
 %type <ColumnDefault>						default_clause
 %type <ColumnDefault>						default_option
-%type <std::vector<NamedColumnConstraint>>			opt_column_constraint_def
-%type <std::vector<NamedColumnConstraint>>			column_constraint_defs
+%type <List<NamedColumnConstraint>>				opt_column_constraint_def
+%type <List<NamedColumnConstraint>>				column_constraint_defs
 %type <NamedColumnConstraint>					column_constraint_def
 %type <std::optional<box<QualifiedName>>>			opt_constraint_name
 %type <ColumnConstraint>					column_constraint
-%type <References*>						references_spec
+%type <box<References>>					references_spec
 %type <MatchOption>						opt_match
 %type <MatchOption>						match_type
 %type <ReferentialTriggeredAction>				opt_referential_triggered_action
@@ -183,7 +189,8 @@ namespace psql_parse {
 %type <TableConstraint>						table_constraint_def
 
 %type <Expression>						value_expr
-%type <std::vector<Expression>>					value_expr_list
+%type <List<Expression>>					value_expr_list
+%type <List<Expression>>					values_list
 %type <Expression>						common_value_expr
 %type <Expression>						bool_value_expr
 %type <bool>							opt_symmetric
@@ -210,9 +217,9 @@ namespace psql_parse {
 %type <box<WithClause>>						with_list;
 %type <box<WithSpec>>						with_list_element;
 
-%type <std::vector<box<SortSpec>>>				opt_order_by_clause
-%type <std::vector<box<SortSpec>>>				order_by_clause
-%type <std::vector<box<SortSpec>>>				sort_spec_list
+%type <List<box<SortSpec>>>					opt_order_by_clause
+%type <List<box<SortSpec>>>					order_by_clause
+%type <List<box<SortSpec>>>					sort_spec_list
 %type <box<SortSpec>>						sort_spec
 %type <SortSpec::Order>						opt_asc_or_desc
 %type <SortSpec::NullOrder>					null_ordering
@@ -226,12 +233,12 @@ namespace psql_parse {
 %type <bool>							fetch_with_ties
 %type <std::optional<box<IntegerLiteral>>>			opt_fetch_quantity
 
-%type <std::vector<Expression>>					target_list
+%type <List<Expression>>					target_list
 %type <Expression>						target_element
-%type <std::vector<RelExpression>>				from_clause
-%type <std::vector<RelExpression>>				from_list
+%type <List<RelExpression>>					from_clause
+%type <List<RelExpression>>					from_list
 %type <RelExpression>						table_ref
-%type <JoinExpr*>						joined_table
+%type <box<JoinExpr>>					joined_table
 %type <JoinExpr::Kind>						join_type
 %type <std::optional<box<TableAlias>>>				opt_alias_clause
 %type <box<TableAlias>>						alias_clause
@@ -239,24 +246,24 @@ namespace psql_parse {
 %type <std::optional<Expression>>				where_clause
 
 %type <std::optional<GroupClause>>				group_clause
-%type <std::vector<Grouping>>					group_by_list
+%type <List<Grouping>>						group_by_list
 %type <Grouping>						group_by_element
 %type <box<GroupingSet>>					empty_grouping_set
 %type <Expression>						column_ref
-%type <std::vector<Expression>>					column_ref_list
+%type <List<Expression>>					column_ref_list
 %type <box<GroupingSet>>					ordinary_grouping_set
-%type <std::vector<box<GroupingSet>>>				ordinary_grouping_set_list
+%type <List<box<GroupingSet>>>					ordinary_grouping_set_list
 %type <box<Rollup>>						rollup_list
 %type <box<Cube>>						cube_list
 %type <box<GroupingSets>>					grouping_sets
 
 %type <std::optional<Expression>>				having_clause
 
-%type <std::vector<box<Window>>>				window_clause
-%type <std::vector<box<Window>>>				window_definition_list
+%type <List<box<Window>>>					window_clause
+%type <List<box<Window>>>					window_definition_list
 %type <box<Window>>						window_definition
 %type <std::optional<Name>>					opt_existing_window_name
-%type <std::vector<Expression>>					opt_partition_clause
+%type <List<Expression>>					opt_partition_clause
 %type <std::optional<Window::Frame>>				opt_frame_clause
 %type <Window::Frame::Unit>					frame_units
 %type <Window::Frame::Bound>					frame_start
@@ -265,6 +272,7 @@ namespace psql_parse {
 
 %type <box<InsertStatement>>					InsertStatement
 %type <InsertStatement::Override>				insert_override
+%type <box<QualifiedName>>					insert_target
 
 %type <box<DeleteStatement>>	  			        DeleteStatement
 %%
@@ -272,10 +280,30 @@ namespace psql_parse {
 %start pseudo_start;
 
 pseudo_start:
-    CreateStatement	{ driver.result_ = $CreateStatement; }
- |  SelectStatement	{ driver.result_ = $SelectStatement; }
- |  InsertStatement	{ driver.result_ = $InsertStatement; }
- |  DeleteStatement	{ driver.result_ = $DeleteStatement; }
+    statement_list
+ ;
+
+/*
+ * A syntax error skips to the end of the statement, the driver decides
+ * whether to go on from there. Errors are reported again from the next
+ * statement on, not only three tokens after the last one.
+ */
+statement_list:
+    opt_statement
+ |  statement_list SEMICOLON { yyerrok; } opt_statement
+ ;
+
+opt_statement:
+    statement							{ driver.emit($statement, @statement); }
+ |  %empty
+ |  error							{ if (!driver.resync()) { YYABORT; } }
+ ;
+
+statement:
+    CreateStatement						{ $$ = $CreateStatement; }
+ |  SelectStatement						{ $$ = $SelectStatement; }
+ |  InsertStatement						{ $$ = $InsertStatement; }
+ |  DeleteStatement						{ $$ = $DeleteStatement; }
  ;
 
 /*
@@ -303,7 +331,7 @@ general_literal:
  |  BIT_VALUE		{ $$ = mkNode<StringLiteral>(@BIT_VALUE, $BIT_VALUE, StringLiteralType::BIT); }
  |  HEX_VALUE		{ $$ = mkNode<StringLiteral>(@HEX_VALUE, $HEX_VALUE, StringLiteralType::HEX); }
  |  NATIONAL_VALUE	{ $$ = mkNode<StringLiteral>(@NATIONAL_VALUE, $NATIONAL_VALUE, StringLiteralType::NATIONAL); }
- |  boolean_literal
+ |  boolean_literal	{ $$ = $boolean_literal; }
  ;
 
 boolean_literal:
@@ -367,14 +395,14 @@ precision_spec:
  ;
 
 opt_length_spec:
-    length_spec
+    length_spec							{ $$ = $length_spec; }
  |  %empty							{ $$ = std::nullopt; }
  ;
 
 length_spec: LP INTEGER_VALUE RP 				{ $$ = $INTEGER_VALUE; };
 
 opt_char_length:
-    char_length
+    char_length							{ $$ = $char_length; }
  |  %empty							{ $$ = std::nullopt; }
  ;
 
@@ -410,7 +438,7 @@ opt_cardinality_clause:
  ;
 
 field_def_list:
-    field_def							{ $$ = std::vector<RowType::FieldDef>(); $$.push_back($field_def); }
+    field_def							{ $$ = List<RowType::FieldDef>(); $$.push_back($field_def); }
  |  field_def_list[list] COMMA field_def			{ $list.push_back($field_def); $$ = $list; }
  ;
 
@@ -429,8 +457,8 @@ opt_scope_clause:
  */
 
 identifier_list:
-    IDENTIFIER[elem] COMMA identifier_list[vec]			{ $vec.push_back($elem); $$ = $vec; }
- |  IDENTIFIER[elem]						{ $$ = std::vector<Name> { $elem }; }
+    identifier_list[vec] COMMA IDENTIFIER[elem]			{ $vec.push_back($elem); $$ = $vec; }
+ |  IDENTIFIER[elem]						{ $$ = List<Name> { $elem }; }
  ;
 
 qualified_name:
@@ -445,7 +473,7 @@ qualified_name:
  ;
 
 qualifier_list:
-    IDENTIFIER[name]						{ $$ = std::vector<Name>(); $$.emplace_back($name); }
+    IDENTIFIER[name]						{ $$ = List<Name>(); $$.emplace_back($name); }
  |  qualifier_list[qn] DOT IDENTIFIER[name]			{ $qn.push_back($name); $$ = $qn; }
  ;
 
@@ -472,19 +500,19 @@ opt_on_commit:
  ;
 
 column_defs_and_constraints:
-    column_def_and_constraint[elem] COMMA column_defs_and_constraints[vec]
+    column_defs_and_constraints[vec] COMMA column_def_and_constraint[elem]
 	{
 		$vec.push_back($elem); $$ = $vec;
 	}
  |  column_def_and_constraint[elem]
 	{
-		$$ = std::vector<std::variant<ColumnDef, TableConstraint>>(); $$.push_back($elem);
+		$$ = List<std::variant<ColumnDef, TableConstraint>>(); $$.push_back($elem);
 	}
  ;
 
 column_def_and_constraint:
-    column_def
- |  table_constraint_def
+    column_def							{ $$ = $column_def; }
+ |  table_constraint_def					{ $$ = $table_constraint_def; }
  ;
 
 column_def:
@@ -498,7 +526,7 @@ column_def:
  ;
 
 opt_default_clause:
-    default_clause
+    default_clause						{ $$ = $default_clause; }
  |  %empty							{ $$ = std::nullopt; }
  ;
 
@@ -518,14 +546,14 @@ default_option:
 
 opt_column_constraint_def:
     column_constraint_defs
- |  %empty							{ $$ = std::vector<NamedColumnConstraint>(); }
+ |  %empty							{ $$ = List<NamedColumnConstraint>(); }
  ;
 
 column_constraint_defs:
-    column_constraint_def[elem] column_constraint_defs[vec]	{ $vec.push_back($elem); $$ = $vec; }
+    column_constraint_defs[vec] column_constraint_def[elem]	{ $vec.push_back($elem); $$ = $vec; }
  |  column_constraint_def[elem]
 	{
-		$$ = std::vector<NamedColumnConstraint>(); $$.push_back($elem);
+		$$ = List<NamedColumnConstraint>(); $$.push_back($elem);
 	}
  ;
 
@@ -653,13 +681,13 @@ bool_predicand:
 	{
 		auto expr = mkNode<BetweenPred>(@$, $val, $low, $high);
 		expr->symmetric = $opt_symmetric;
-		$$ = expr;
+		$$ = std::move(expr);
 	}
  |  bool_predicand[val] NOT BETWEEN opt_symmetric bool_predicand[low] AND bool_predicand[high]	%prec BETWEEN
 	{
 		auto expr = mkNode<BetweenPred>(@$, $val, $low, $high);
 		expr->symmetric = $opt_symmetric;
-		$$ = mkNode<UnaryOp>(@$, UnaryOp::Op::NOT, expr);
+		$$ = mkNode<UnaryOp>(@$, UnaryOp::Op::NOT, std::move(expr));
 	}
  |  bool_predicand[val] IN in_expr[rel] 	%prec IN	{ $$ = mkNode<InPred>(@$, $val, $rel); }
  |  bool_predicand[val] NOT IN in_expr[rel]	%prec IN 	{ $$ = mkNotNode<InPred>(@$, $val, $rel); }
@@ -694,7 +722,7 @@ in_expr:
  ;
 
 value_expr_list:
-    value_expr[elem]						{ $$ = std::vector<Expression>(); $$.emplace_back($elem); }
+    value_expr[elem]						{ $$ = List<Expression>(); $$.emplace_back($elem); }
  |  value_expr_list[list] COMMA value_expr[elem]		{ $list.emplace_back($elem); $$ = $list; }
  ;
 
@@ -715,7 +743,7 @@ common_value_expr:
  |  common_value_expr[left] STAR common_value_expr[right]	{ $$ = mkNode<BinaryOp>(@$, $left, BinaryOp::Op::MULT, $right); }
  |  PLUS common_value_expr[inner]				{ $$ = $inner; }
  |  MINUS common_value_expr[inner]				{ $$ = mkNode<UnaryOp>(@$, UnaryOp::Op::NEG, $inner); }
- |  aggregate_expr
+ |  aggregate_expr						{ $$ = $aggregate_expr; }
  ;
 
 comp_op:
@@ -729,6 +757,7 @@ comp_op:
 
 value_expr_no_parens:
     unsigned_literal						{ $$ = $unsigned_literal; }
+ |  PARAM							{ $$ = mkNode<Param>(@$, $PARAM); }
  |  IDENTIFIER							{ $$ = mkNode<Var>(@$, $IDENTIFIER); }
  ;
 
@@ -853,11 +882,14 @@ with_list_element:
  ;
 
 
-select_clause: simple_select | select_with_parens ;
+select_clause:
+    simple_select						{ $$ = $simple_select; }
+ |  select_with_parens						{ $$ = $select_with_parens; }
+ ;
 
 opt_order_by_clause:
     order_by_clause
- |  %empty							{ $$ = std::vector<box<SortSpec>>(); }
+ |  %empty							{ $$ = List<box<SortSpec>>(); }
  ;
 
 order_by_clause:
@@ -865,7 +897,7 @@ order_by_clause:
  ;
 
 sort_spec_list:
-    sort_spec							{ $$ = std::vector<box<SortSpec>>(); $$.emplace_back($sort_spec); }
+    sort_spec							{ $$ = List<box<SortSpec>>(); $$.emplace_back($sort_spec); }
  |  sort_spec_list[list] COMMA sort_spec			{ $list.push_back($sort_spec); $$ = $list; }
  ;
 
@@ -891,7 +923,7 @@ null_ordering:
  ;
 
 opt_offset_clause:
-    offset_clause
+    offset_clause						{ $$ = $offset_clause; }
  |  %empty                                                      { $$ = std::nullopt; }
  ;
 
@@ -949,30 +981,39 @@ simple_select:
 		expr->having_clause = $having_clause;
 		expr->window_clause = $window_clause;
 		expr->set_quantifier = $opt_set_quantifier;
-		$$ = expr;
+		$$ = std::move(expr);
 	}
- |  VALUES LP value_expr_list RP				{ $$ = mkNode<ValuesExpr>(@$, $value_expr_list); }
+ |  VALUES LP { driver.beginValues(@$); } values_list RP	{ $$ = mkNode<ValuesExpr>(@$, driver.endValues($values_list)); }
  |  TABLE qualified_name[table_name]				{ $$ = mkNode<TableName>(@$, $table_name); }
  |  select_clause[left] UNION opt_set_quantifier[quant] select_clause[right]
 	{
 		auto expr = mkNode<SetOp>(@$, $left, SetOp::Op::UNION, $right);
 		expr->quantifier = $quant;
-		$$ = expr;
+		$$ = std::move(expr);
 	}
  |  select_clause[left] INTERSECT opt_set_quantifier[quant] select_clause[right]
     	{
     		auto expr = mkNode<SetOp>(@$, $left, SetOp::Op::INTERSECT, $right);
     		expr->quantifier = $quant;
-		$$ = expr;
+		$$ = std::move(expr);
 	}
  |  select_clause[left] EXCEPT opt_set_quantifier[quant] select_clause[right]
 	{
 		auto expr = mkNode<SetOp>(@$, $left, SetOp::Op::EXCEPT, $right);
 		expr->quantifier = $quant;
-		$$ = expr;
+		$$ = std::move(expr);
 	}
  ;
 
+/*
+ * The driver may hand the rows of an INSERT's VALUES to the caller as
+ * they are parsed instead of collecting them here
+ */
+values_list:
+    value_expr[row]						{ $$ = List<Expression>(); driver.addRow($$, $row); }
+ |  values_list[list] COMMA value_expr[row]			{ $$ = $list; driver.addRow($$, $row); }
+ ;
+
 opt_set_quantifier:
     ALL								{ $$ = SetQuantifier::ALL; }
  |  DISTINCT							{ $$ = SetQuantifier::DISTINCT; }
@@ -991,7 +1032,7 @@ opt_set_quantifier:
  *  MISSING: <qualified asterisk>
  */
 target_list:
-   target_element						{ $$ = std::vector<Expression>(); $$.emplace_back($target_element); }
+   target_element						{ $$ = List<Expression>(); $$.emplace_back($target_element); }
  | target_list[list] COMMA target_element			{ $list.emplace_back($target_element); $$ = $list; }
  ;
 
@@ -1003,11 +1044,11 @@ target_element:
 
 from_clause:
     FROM from_list						{ $$ = $from_list; }
- |  %empty 							{ $$ = std::vector<RelExpression>(); }
+ |  %empty 							{ $$ = List<RelExpression>(); }
  ;
 
 from_list:
-    table_ref							{ $$ = std::vector<RelExpression>(); $$.emplace_back($table_ref);}
+    table_ref							{ $$ = List<RelExpression>(); $$.emplace_back($table_ref);}
  |  from_list[list] COMMA table_ref				{ $list.emplace_back($table_ref); $$ = $list; }
  ;
 
@@ -1062,7 +1103,7 @@ join_type:
 opt_outer: OUTER | %empty ;
 
 opt_alias_clause:
-    alias_clause
+    alias_clause						{ $$ = $alias_clause; }
  |  %empty							{ $$ = std::nullopt; }
  ;
 
@@ -1084,11 +1125,17 @@ group_clause:
  ;
 
 group_by_list:
-    group_by_element[elem]					{ $$ = std::vector<Grouping>(); $$.emplace_back($elem); }
+    group_by_element[elem]					{ $$ = List<Grouping>(); $$.emplace_back($elem); }
  |  group_by_list[list] COMMA group_by_element[elem]		{ $list.emplace_back($elem); $$ = $list; }
  ;
 
-group_by_element:  ordinary_grouping_set | empty_grouping_set | rollup_list | cube_list | grouping_sets ;
+group_by_element:
+    ordinary_grouping_set					{ $$ = $ordinary_grouping_set; }
+ |  empty_grouping_set						{ $$ = $empty_grouping_set; }
+ |  rollup_list							{ $$ = $rollup_list; }
+ |  cube_list							{ $$ = $cube_list; }
+ |  grouping_sets						{ $$ = $grouping_sets; }
+ ;
 
 empty_grouping_set:
     LP RP							{ $$ = mkNode<GroupingSet>(@$); }
@@ -1099,15 +1146,15 @@ column_ref:
 	{
 		auto var = mkNode<Var>(@name, $name);
 		if ($opt_collate_clause.has_value()) {
-                    $$ = mkNode<Collate>(@$, var, std::move($opt_collate_clause.value()));
+                    $$ = mkNode<Collate>(@$, std::move(var), std::move($opt_collate_clause.value()));
 		} else {
-		    $$ = var;
+		    $$ = std::move(var);
 		}
         }
  ;
 
 column_ref_list:
-    column_ref[elem]						{ $$ = std::vector<Expression>(); $$.emplace_back($elem); }
+    column_ref[elem]						{ $$ = List<Expression>(); $$.emplace_back($elem); }
  |  column_ref_list[list] COMMA column_ref[elem]		{ $list.emplace_back($elem); $$ = $list; }
  ;
 
@@ -1119,7 +1166,7 @@ ordinary_grouping_set:
 ordinary_grouping_set_list:
     ordinary_grouping_set[elem]
 	{
-		$$ = std::vector<box<GroupingSet>>();
+		$$ = List<box<GroupingSet>>();
 		$$.emplace_back($elem);
 	}
  |  ordinary_grouping_set_list[list] COMMA ordinary_grouping_set[elem]
@@ -1147,11 +1194,11 @@ having_clause:
 
 window_clause:
     WINDOW window_definition_list				{ $$ = $window_definition_list; }
- |  %empty							{ $$ = std::vector<box<Window>>(); }
+ |  %empty							{ $$ = List<box<Window>>(); }
  ;
 
 window_definition_list:
-    window_definition[elem]					{ $$ = std::vector<box<Window>>(); $$.push_back($elem); }
+    window_definition[elem]					{ $$ = List<box<Window>>(); $$.push_back($elem); }
  |  window_definition_list[list] COMMA window_definition[elem]	{ $list.push_back($elem); $$ = $list; }
  ;
 
@@ -1176,7 +1223,7 @@ opt_existing_window_name:
 
 opt_partition_clause:
     PARTITION BY column_ref_list				{ $$ = $column_ref_list; }
- |  %empty							{ $$ = std::vector<Expression>(); }
+ |  %empty							{ $$ = List<Expression>(); }
  ;
 
 /*
@@ -1213,7 +1260,7 @@ frame_units:
 
 frame_start:
     UNBOUNDED PRECEDING						{ $$ = std::make_pair(Window::Frame::BoundKind::PRECEDING, Expression()); }
- |  unsigned_literal PRECEDING					{ std::make_pair(Window::Frame::BoundKind::PRECEDING, $unsigned_literal); }
+ |  unsigned_literal PRECEDING					{ $$ = std::make_pair(Window::Frame::BoundKind::PRECEDING, $unsigned_literal); }
  |  CURRENT ROW							{ $$ = std::make_pair(Window::Frame::BoundKind::PRECEDING, Expression()); }
  ;
 
@@ -1241,37 +1288,41 @@ opt_frame_exclusion:
  * Duplication necessary to prevent shift/reduce conflicts...
  */
 InsertStatement:
-    INSERT INTO qualified_name[table_name] LP identifier_list RP insert_override select_with_without_parens
+    insert_target[table_name] LP identifier_list RP insert_override select_with_without_parens
 	{
 		$$ = mkNode<InsertStatement>(@$, $table_name);
 		$$->column_names = $identifier_list;
 		$$->override = $insert_override;
 		$$->source = $select_with_without_parens;
 	}
- |  INSERT INTO qualified_name[table_name] insert_override select_with_without_parens
+ |  insert_target[table_name] insert_override select_with_without_parens
 	{
 		$$ = mkNode<InsertStatement>(@$, $table_name);
 		$$->override = $insert_override;
 		$$->source = $select_with_without_parens;
 	}
- |  INSERT INTO qualified_name[table_name] LP identifier_list RP select_with_without_parens
+ |  insert_target[table_name] LP identifier_list RP select_with_without_parens
 	{
 		$$ = mkNode<InsertStatement>(@$, $table_name);
 		$$->column_names = $identifier_list;
 		$$->source = $select_with_without_parens;
 	}
- |  INSERT INTO qualified_name[table_name] select_with_without_parens
+ |  insert_target[table_name] select_with_without_parens
 	{
 		$$ = mkNode<InsertStatement>(@$, $table_name);
 		$$->source = $select_with_without_parens;
 	}
- |  INSERT INTO qualified_name[table_name] DEFAULT VALUES
+ |  insert_target[table_name] DEFAULT VALUES
 	{
 		$$ = mkNode<InsertStatement>(@$, $table_name);
 		$$->source = InsertStatement::Default {};
 	}
  ;
 
+insert_target:
+    INSERT INTO qualified_name					{ $$ = $qualified_name; driver.beginInsert(*$$); }
+ ;
+
 insert_override:
     OVERRIDING USER VALUE					{ $$ = InsertStatement::Override::USER_VALUE; }
  |  OVERRIDING SYSTEM VALUE					{ $$ = InsertStatement::Override::SYSTEM_VALUE; }
@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <cstring>
+
+#include "psql_parse/keywords.hpp"
 #include "psql_parse/scanner.hpp"
+#include "psql_parse/simd.hpp"
 
 namespace psql_parse {
     scanner::scanner(std::istream *in, std::ostream *out)
@@ -13,9 +18,107 @@ namespace psql_parse {
 		ident_buffer.clear();
 	}
 
+	parser::symbol_type scanner::identifier(const char *text, std::size_t length) {
+		// lowercase into a reused buffer, only new names are copied by the symbol table
+		lower_buffer.assign(text, length);
+		for (auto &c : lower_buffer) {
+			if (c >= 'A' && c <= 'Z') {
+				c = static_cast<char>(c - 'A' + 'a');
+			}
+		}
+
+		if (auto token = keyword_table.find(lower_buffer)) {
+			return parser::symbol_type(*token, loc);
+		}
+
+		auto &cached = symbol_cache_[std::hash<std::string_view>{}(lower_buffer) % symbol_cache_.size()];
+		if (cached.str() != lower_buffer) {
+			cached = Name(lower_buffer);
+		}
+		return parser::make_IDENTIFIER(cached, loc);
+	}
+
+	bool scanner::scan_quoted(std::string &buffer, char quote, bool doubled) {
+		for (;;) {
+			auto rest = unmatched();
+			auto length = simd::findQuote(rest, quote);
+			buffer.append(rest.data(), length);
+
+			if (length == rest.size()) {
+				advance(length);
+				return false;
+			}
+			if (!doubled) {
+				advance(length + 1);
+				return true;
+			}
+			// a quote at the very end may be the first half of a doubled one
+			if (length + 1 == rest.size()) {
+				advance(length);
+				return false;
+			}
+			if (rest[length + 1] != quote) {
+				advance(length + 1);
+				return true;
+			}
+			buffer.push_back(quote);
+			advance(length + 2);
+		}
+	}
+
+	parser::symbol_type scanner::string_token() {
+		switch (string_type) {
+		case StringLiteralType::BIT:
+			return parser::make_BIT_VALUE(string_buffer, loc);
+		case StringLiteralType::HEX:
+			return parser::make_HEX_VALUE(string_buffer, loc);
+		case StringLiteralType::NATIONAL:
+			return parser::make_NATIONAL_VALUE(string_buffer, loc);
+		case StringLiteralType::CHAR:
+			break;
+		}
+		return parser::make_STRING_VALUE(string_buffer, loc);
+	}
+
     void scanner::reset() {
         loc = location();
+        offset_ = 0;
         string_buffer.clear();
         ident_buffer.clear();
     }
+
+    void scanner::reset(std::istream &in) {
+        reset();
+        input_.reset();
+        yyrestart(in);
+    }
+
+    void scanner::reset(std::string_view input) {
+        reset();
+        input_ = input;
+        yyrestart(yyin);
+    }
+
+    std::size_t scanner::bytesReserved() const {
+        return string_buffer.capacity() + ident_buffer.capacity() + lower_buffer.capacity();
+    }
+
+    void scanner::trim(std::size_t bytes) {
+        for (auto *buffer : { &string_buffer, &ident_buffer, &lower_buffer }) {
+            if (buffer->capacity() > bytes) {
+                std::string().swap(*buffer);
+            }
+        }
+    }
+
+    int scanner::LexerInput(char *buf, int max_size) {
+        if (!input_) {
+            return yyFlexLexer::LexerInput(buf, max_size);
+        }
+
+        auto n = std::min(input_->size(), static_cast<std::size_t>(max_size));
+        std::memcpy(buf, input_->data(), n);
+        input_->remove_prefix(n);
+        return static_cast<int>(n);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "psql_parse/session.hpp"
+
+namespace psql_parse {
+
+	ParseSession::ParseSession(std::size_t high_water)
+	: driver_()
+	, high_water_(high_water) {
+		driver_.useArena(true);
+		driver_.recoverErrors(true);
+	}
+
+	const Statement* ParseSession::parse(std::string_view input) {
+		if (driver_.bytesReserved() > high_water_) {
+			driver_.trim(high_water_);
+		}
+		if (!driver_.parse(input)) {
+			return nullptr;
+		}
+		return &driver_.getResult();
+	}
+}
@@ -0,0 +1,157 @@
+#include <bit>
+
+#include "psql_parse/simd.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PSQL_PARSE_X86
+#endif
+
+namespace psql_parse::simd {
+
+	namespace {
+		using BlankRun = std::size_t (*)(const char*, std::size_t);
+		using FindQuote = std::size_t (*)(const char*, std::size_t, char);
+
+		struct Kernels {
+			BlankRun blank_run;
+			FindQuote find_quote;
+			const char* name;
+		};
+
+		bool isBlank(char c) {
+			return c == ' ' || c == '\t' || c == '\r' || c == '\f';
+		}
+
+		std::size_t blankRunScalar(const char* text, std::size_t size) {
+			std::size_t i = 0;
+			while (i < size && isBlank(text[i])) {
+				i++;
+			}
+			return i;
+		}
+
+		std::size_t findQuoteScalar(const char* text, std::size_t size, char quote) {
+			std::size_t i = 0;
+			while (i < size && text[i] != quote) {
+				i++;
+			}
+			return i;
+		}
+
+#ifdef PSQL_PARSE_X86
+		/*
+		 * Both kernels compare a whole register of bytes at once and turn
+		 * the result into a bit mask, one bit per byte; the answer is the
+		 * first set bit. The tail that does not fill a register is left
+		 * to the scalar loop.
+		 */
+		__attribute__((target("sse2")))
+		std::size_t blankRunSse2(const char* text, std::size_t size) {
+			const __m128i space = _mm_set1_epi8(' ');
+			const __m128i tab = _mm_set1_epi8('\t');
+			const __m128i cr = _mm_set1_epi8('\r');
+			const __m128i ff = _mm_set1_epi8('\f');
+
+			std::size_t i = 0;
+			for (; i + 16 <= size; i += 16) {
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+				__m128i blank = _mm_or_si128(
+						_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+						_mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, ff)));
+				auto other = ~static_cast<unsigned>(_mm_movemask_epi8(blank)) & 0xffffu;
+				if (other != 0) {
+					return i + std::countr_zero(other);
+				}
+			}
+			return i + blankRunScalar(text + i, size - i);
+		}
+
+		__attribute__((target("sse2")))
+		std::size_t findQuoteSse2(const char* text, std::size_t size, char quote) {
+			const __m128i needle = _mm_set1_epi8(quote);
+
+			std::size_t i = 0;
+			for (; i + 16 <= size; i += 16) {
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+				auto found = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+				if (found != 0) {
+					return i + std::countr_zero(found);
+				}
+			}
+			return i + findQuoteScalar(text + i, size - i, quote);
+		}
+
+		__attribute__((target("avx2")))
+		std::size_t blankRunAvx2(const char* text, std::size_t size) {
+			const __m256i space = _mm256_set1_epi8(' ');
+			const __m256i tab = _mm256_set1_epi8('\t');
+			const __m256i cr = _mm256_set1_epi8('\r');
+			const __m256i ff = _mm256_set1_epi8('\f');
+
+			std::size_t i = 0;
+			for (; i + 32 <= size; i += 32) {
+				__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+				__m256i blank = _mm256_or_si256(
+						_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+						_mm256_or_si256(_mm256_cmpeq_epi8(chunk, cr), _mm256_cmpeq_epi8(chunk, ff)));
+				auto other = ~static_cast<unsigned>(_mm256_movemask_epi8(blank));
+				if (other != 0) {
+					return i + std::countr_zero(other);
+				}
+			}
+			return i + blankRunSse2(text + i, size - i);
+		}
+
+		__attribute__((target("avx2")))
+		std::size_t findQuoteAvx2(const char* text, std::size_t size, char quote) {
+			const __m256i needle = _mm256_set1_epi8(quote);
+
+			std::size_t i = 0;
+			for (; i + 32 <= size; i += 32) {
+				__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+				auto found = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+				if (found != 0) {
+					return i + std::countr_zero(found);
+				}
+			}
+			return i + findQuoteSse2(text + i, size - i, quote);
+		}
+#endif
+
+		Kernels select() {
+#ifdef PSQL_PARSE_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2")) {
+				return { blankRunAvx2, findQuoteAvx2, "avx2" };
+			}
+			if (__builtin_cpu_supports("sse2")) {
+				return { blankRunSse2, findQuoteSse2, "sse2" };
+			}
+#endif
+			return { blankRunScalar, findQuoteScalar, "scalar" };
+		}
+
+		// a function local static, so scanners created during static initialization work too
+		const Kernels& kernels() {
+			static const Kernels selected = select();
+			return selected;
+		}
+	}
+
+	std::size_t blankRun(std::string_view text) {
+		// most blanks are a single space, decide those without a call through a pointer
+		if (text.size() < 2 || !isBlank(text[1])) {
+			return !text.empty() && isBlank(text[0]) ? 1 : 0;
+		}
+		return kernels().blank_run(text.data(), text.size());
+	}
+
+	std::size_t findQuote(std::string_view text, char quote) {
+		return kernels().find_quote(text.data(), text.size(), quote);
+	}
+
+	const char* kernel() {
+		return kernels().name;
+	}
+}
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <utility>
+
+#include "psql_parse/stats.hpp"
+
+namespace psql_parse {
+
+	namespace {
+		// in the order of NodeTypes
+		constexpr const char* node_names[] = {
+				"CreateStatement", "InsertStatement", "DeleteStatement", "SelectStatement",
+				"JoinExpr", "TableName", "TableAlias", "SelectExpr", "ValuesExpr", "SetOp", "Query",
+				"WithClause", "WithSpec", "Window",
+				"AliasExpr", "Asterisk", "IntegerLiteral", "FloatLiteral", "StringLiteral", "BooleanLiteral", "Param",
+				"UnaryOp", "BinaryOp", "RowExpr", "RowSubquery", "Var", "Collate", "IsExpr",
+				"BetweenPred", "InPred", "LikePred", "ExistsPred", "UniquePred", "SortSpec",
+				"GroupingSet", "GroupingSets", "Rollup", "Cube", "AggregateExpr",
+				"QualifiedName", "References", "RowType", "RefType", "ArrayType", "MultiSetType"
+		};
+
+		static_assert(std::size(node_names) == nodeTypeCount);
+	}
+
+	void ParseStats::add(const ParseStats& other) {
+		tokens += other.tokens;
+		for (std::size_t i = 0; i < nodes.size(); i++) {
+			nodes[i] += other.nodes[i];
+		}
+		node_bytes += other.node_bytes;
+		arena_bytes += other.arena_bytes;
+		max_stack_depth = std::max(max_stack_depth, other.max_stack_depth);
+		total_ns += other.total_ns;
+		scan_ns += other.scan_ns;
+	}
+
+	const char* nodeTypeName(std::size_t index) {
+		return index < nodeTypeCount ? node_names[index] : "";
+	}
+
+	void StatsCollector::add(const ParseStats& stats) {
+		std::lock_guard lock(mutex_);
+		current_.parses++;
+		current_.totals.add(stats);
+	}
+
+	StatsCollector::Snapshot StatsCollector::snapshot() const {
+		std::lock_guard lock(mutex_);
+		return current_;
+	}
+
+	StatsCollector::Snapshot StatsCollector::take() {
+		std::lock_guard lock(mutex_);
+		return std::exchange(current_, Snapshot {});
+	}
+}
@@ -0,0 +1,53 @@
+#include <cstring>
+#include <mutex>
+
+#include "psql_parse/symbol.hpp"
+
+namespace psql_parse {
+
+	const Symbol::Entry Symbol::empty_ = { std::hash<std::string_view>{}(std::string_view()), 0, "" };
+
+	Symbol::Symbol(std::string_view text)
+	: Symbol(SymbolTable::global().intern(text)) {}
+
+	Symbol SymbolTable::intern(std::string_view text) {
+		if (text.empty()) {
+			return Symbol(&Symbol::empty_);
+		}
+
+		{
+			std::shared_lock lock(mutex_);
+			auto it = entries_.find(text);
+			if (it != entries_.end()) {
+				return Symbol(it->second);
+			}
+		}
+
+		std::unique_lock lock(mutex_);
+		// Another thread may have interned the same text in between
+		auto it = entries_.find(text);
+		if (it != entries_.end()) {
+			return Symbol(it->second);
+		}
+
+		auto data = static_cast<char*>(storage_.allocate(text.size(), 1));
+		std::memcpy(data, text.data(), text.size());
+		auto entry = storage_.make<Symbol::Entry>(Symbol::Entry {
+			entries_.hash_function()(text),
+			text.size(),
+			data
+		});
+		entries_.emplace(std::string_view(data, text.size()), entry);
+		return Symbol(entry);
+	}
+
+	std::size_t SymbolTable::size() const {
+		std::shared_lock lock(mutex_);
+		return entries_.size();
+	}
+
+	SymbolTable& SymbolTable::global() {
+		static SymbolTable table;
+		return table;
+	}
+}
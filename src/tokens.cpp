@@ -0,0 +1,246 @@
+#include <array>
+#include <utility>
+
+#include "psql_parse/keywords.hpp"
+#include "psql_parse/simd.hpp"
+#include "psql_parse/tokens.hpp"
+
+namespace psql_parse {
+
+	namespace {
+		using Kind = parser::symbol_kind_type;
+		using symbol_kind = parser::symbol_kind;
+
+		// what the first byte of a token makes it
+		enum class Start : std::uint8_t {
+			INVALID, BLANK, NAME, DIGIT, QUOTE, DQUOTE, PUNCT, DOT, DOLLAR, LESS, GREATER, BAR
+		};
+
+		struct ByteTable {
+			std::array<Start, 256> start {};
+			// bytes that go on a name, after its first one
+			std::array<bool, 256> name {};
+			// the single byte tokens
+			std::array<Kind, 256> punct {};
+		};
+
+		constexpr ByteTable byte_table = [] {
+			ByteTable table;
+			for (auto& kind : table.punct) {
+				kind = symbol_kind::S_YYUNDEF;
+			}
+			for (unsigned char c : { ' ', '\t', '\r', '\f', '\n' }) {
+				table.start[c] = Start::BLANK;
+			}
+			for (int c = 0; c < 256; c++) {
+				bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+				bool digit = c >= '0' && c <= '9';
+				if (letter) {
+					table.start[c] = Start::NAME;
+				}
+				if (digit) {
+					table.start[c] = Start::DIGIT;
+				}
+				table.name[c] = letter || digit;
+			}
+			std::pair<unsigned char, Kind> punct[] = {
+					{ '(', symbol_kind::S_LP }, { ')', symbol_kind::S_RP },
+					{ '[', symbol_kind::S_LB }, { ']', symbol_kind::S_RB },
+					{ ',', symbol_kind::S_COMMA }, { ';', symbol_kind::S_SEMICOLON },
+					{ '+', symbol_kind::S_PLUS }, { '-', symbol_kind::S_MINUS },
+					{ '/', symbol_kind::S_SLASH }, { '*', symbol_kind::S_STAR },
+					{ '=', symbol_kind::S_EQUAL }
+			};
+			for (auto [c, kind] : punct) {
+				table.start[c] = Start::PUNCT;
+				table.punct[c] = kind;
+			}
+			table.start['\''] = Start::QUOTE;
+			table.start['"'] = Start::DQUOTE;
+			table.start['.'] = Start::DOT;
+			table.start['$'] = Start::DOLLAR;
+			table.start['<'] = Start::LESS;
+			table.start['>'] = Start::GREATER;
+			table.start['|'] = Start::BAR;
+			return table;
+		}();
+
+		class Tokenizer {
+			const char* text_;
+			std::size_t size_;
+			std::vector<Token>& tokens_;
+
+			[[nodiscard]] unsigned char at(std::size_t i) const {
+				return i < size_ ? static_cast<unsigned char>(text_[i]) : 0;
+			}
+
+			void push(std::size_t begin, std::size_t end, Kind kind) {
+				tokens_.push_back(Token { static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end - begin), kind });
+			}
+
+			std::size_t digits(std::size_t i) const {
+				while (at(i) >= '0' && at(i) <= '9') {
+					i++;
+				}
+				return i;
+			}
+
+			// from past the opening quote to past the closing one, or npos if it is missing
+			std::size_t quoted(std::size_t i, char quote, bool doubled) const {
+				for (;;) {
+					i += simd::findQuote({ text_ + i, size_ - i }, quote);
+					if (i == size_) {
+						return std::string_view::npos;
+					}
+					if (!doubled || at(i + 1) != static_cast<unsigned char>(quote)) {
+						return i + 1;
+					}
+					i += 2;
+				}
+			}
+
+			// a name or a keyword; keywords are found whatever their case, like the scanner does
+			Kind name(std::size_t begin, std::size_t end) const {
+				auto token = keyword_table.findIgnoringCase({ text_ + begin, end - begin });
+				// with api.token.raw, token kinds are the symbol kinds
+				return token ? static_cast<Kind>(*token) : symbol_kind::S_IDENTIFIER;
+			}
+
+			// a quoted literal starting at begin, its opening quote at quote
+			std::size_t literal(std::size_t begin, std::size_t quote, Kind kind) {
+				auto end = quoted(quote + 1, '\'', true);
+				if (end == std::string_view::npos) {
+					push(begin, size_, symbol_kind::S_YYUNDEF);
+					return size_;
+				}
+				push(begin, end, kind);
+				return end;
+			}
+
+		public:
+			Tokenizer(std::string_view source, std::vector<Token>& tokens)
+			: text_(source.data())
+			, size_(source.size())
+			, tokens_(tokens) { }
+
+			void run() {
+				std::size_t i = 0;
+				for (;;) {
+					// blanks, mostly a single space, are skipped here rather than
+					// dispatched on like a token
+					while (byte_table.start[at(i)] == Start::BLANK) {
+						i++;
+					}
+					if (i >= size_) {
+						break;
+					}
+					auto begin = i;
+					auto c = at(i);
+					switch (byte_table.start[c]) {
+					case Start::BLANK:
+						break;
+					case Start::NAME:
+						// b'...', n'...' and x'...' are literals, not names
+						if (at(i + 1) == '\'') {
+							switch (c) {
+							case 'b': case 'B':
+								i = literal(begin, i + 1, symbol_kind::S_BIT_VALUE);
+								continue;
+							case 'n': case 'N':
+								i = literal(begin, i + 1, symbol_kind::S_NATIONAL_VALUE);
+								continue;
+							case 'x': case 'X':
+								i = literal(begin, i + 1, symbol_kind::S_HEX_VALUE);
+								continue;
+							default:
+								break;
+							}
+						}
+						i++;
+						while (byte_table.name[at(i)]) {
+							i++;
+						}
+						push(begin, i, name(begin, i));
+						break;
+					case Start::DIGIT:
+						i = digits(i);
+						if (at(i) == '.') {
+							i = digits(i + 1);
+							push(begin, i, symbol_kind::S_FLOAT_VALUE);
+						} else {
+							push(begin, i, symbol_kind::S_INTEGER_VALUE);
+						}
+						break;
+					case Start::DOT:
+						if (at(i + 1) >= '0' && at(i + 1) <= '9') {
+							i = digits(i + 1);
+							push(begin, i, symbol_kind::S_FLOAT_VALUE);
+						} else {
+							push(begin, ++i, symbol_kind::S_DOT);
+						}
+						break;
+					case Start::QUOTE:
+						i = literal(begin, i, symbol_kind::S_STRING_VALUE);
+						break;
+					case Start::DQUOTE:
+						i = quoted(i + 1, '"', false);
+						if (i == std::string_view::npos) {
+							i = size_;
+							push(begin, i, symbol_kind::S_YYUNDEF);
+						} else {
+							push(begin, i, symbol_kind::S_IDENTIFIER);
+						}
+						break;
+					case Start::PUNCT:
+						push(begin, ++i, byte_table.punct[c]);
+						break;
+					case Start::DOLLAR:
+						if (at(i + 1) >= '0' && at(i + 1) <= '9') {
+							i = digits(i + 1);
+							push(begin, i, symbol_kind::S_PARAM);
+						} else {
+							push(begin, ++i, symbol_kind::S_YYUNDEF);
+						}
+						break;
+					case Start::LESS:
+						if (at(i + 1) == '>') {
+							push(begin, i += 2, symbol_kind::S_NOT_EQUAL);
+						} else if (at(i + 1) == '=') {
+							push(begin, i += 2, symbol_kind::S_LESS_EQUAL);
+						} else {
+							push(begin, ++i, symbol_kind::S_LESS);
+						}
+						break;
+					case Start::GREATER:
+						if (at(i + 1) == '=') {
+							push(begin, i += 2, symbol_kind::S_GREATER_EQUAL);
+						} else {
+							push(begin, ++i, symbol_kind::S_GREATER);
+						}
+						break;
+					case Start::BAR:
+						if (at(i + 1) == '|') {
+							push(begin, i += 2, symbol_kind::S_CONCAT);
+						} else {
+							push(begin, ++i, symbol_kind::S_YYUNDEF);
+						}
+						break;
+					case Start::INVALID:
+						push(begin, ++i, symbol_kind::S_YYUNDEF);
+						break;
+					}
+				}
+			}
+		};
+	}
+
+	void tokenize(std::string_view source, std::vector<Token>& tokens) {
+		Tokenizer(source, tokens).run();
+	}
+
+	std::vector<Token> tokenize(std::string_view source) {
+		std::vector<Token> tokens;
+		tokenize(source, tokens);
+		return tokens;
+	}
+}
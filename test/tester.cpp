@@ -1,9 +1,26 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <sstream>
 #include <functional>
+#include <new>
+#include <random>
 
 #include "catch2/catch_test_macros.hpp"
 
+#include "psql_parse/batch.hpp"
+#include "psql_parse/cache.hpp"
+#include "psql_parse/deparse.hpp"
+#include "psql_parse/document.hpp"
 #include "psql_parse/driver.hpp"
+#include "psql_parse/fingerprint.hpp"
+#include "psql_parse/flat.hpp"
+#include "psql_parse/keywords.hpp"
+#include "psql_parse/parameterize.hpp"
+#include "psql_parse/session.hpp"
+#include "psql_parse/simd.hpp"
+#include "psql_parse/stats.hpp"
+#include "psql_parse/tokens.hpp"
 #include "psql_parse/visit.hpp"
 
 using Expression = psql_parse::Expression;
@@ -13,6 +30,30 @@ using SelectExpr = psql_parse::SelectExpr;
 using Query = psql_parse::Query;
 using psql_parse::box;
 
+/*
+ * Every allocation in the test binary goes through here, so a test can
+ * check that some code does not allocate
+ */
+namespace {
+    std::atomic<std::size_t> allocations { 0 };
+}
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
 namespace {
     auto makeStmt(psql_parse::RelExpression exprPtr) -> box<SelectStatement> {
         auto q = new Query(std::move(exprPtr));
@@ -96,6 +137,32 @@ TEST_CASE( "lexing identifiers", "[lex-ident]") {
 
 		REQUIRE(result == expected);
 	}
+
+	SECTION( "keywords in any case, underscores and keyword prefixes" ) {
+		REQUIRE(parser("SeLeCt a FrOm t") == parser("select a from t"));
+		REQUIRE(parser("select l_orderkey, _x from line_item") == parser("select L_ORDERKEY, _X from LINE_ITEM"));
+		REQUIRE(parser("select ascx") == makeStmt(new psql_parse::Var("ascx")));
+		REQUIRE(parser("select selection") == makeStmt(new psql_parse::Var("selection")));
+		mustNotParse(driver, "select from");
+		mustNotParse(driver, "select a fromm t");
+	}
+
+	SECTION( "every keyword is found" ) {
+		for (auto &keyword : psql_parse::keywords) {
+			INFO(keyword.text);
+			REQUIRE(psql_parse::keyword_table.find(keyword.text) == keyword.token);
+			std::string longer(keyword.text);
+			longer += "x";
+			REQUIRE_FALSE(psql_parse::keyword_table.find(longer).has_value());
+		}
+		REQUIRE_FALSE(psql_parse::keyword_table.find("a").has_value());
+		REQUIRE_FALSE(psql_parse::keyword_table.find("SELECT").has_value());
+
+		REQUIRE(psql_parse::keyword_table.findIgnoringCase("SeLeCt") == psql_parse::parser::token::TOK_SELECT);
+		REQUIRE(psql_parse::keyword_table.findIgnoringCase("CURRENT_USER") == psql_parse::parser::token::TOK_CURRENT_USER);
+		REQUIRE_FALSE(psql_parse::keyword_table.findIgnoringCase("SELECTS").has_value());
+		REQUIRE_FALSE(psql_parse::keyword_table.findIgnoringCase("s@lect").has_value());
+	}
 }
 
 TEST_CASE( "set operations", "set-ops" ) {
@@ -162,228 +229,1087 @@ TEST_CASE( "set operations", "set-ops" ) {
     }
 }
 
+namespace {
+    // one statement for every construct the grammar supports
+    const char* concepts[] = {
+        /*
+         * Numbers & Arithmetic
+         */
+        "select 1",
+        "select 1.0",
+        "select -1",
+        "select +1",
+        "select 2 * 3, 2+3, 2-3, 2/3",
+        /*
+         * Boolean Literals
+         */
+        "select TRUE,FALSE,UNKNOWN from whatever",
+        /*
+         * Identifiers;
+         */
+        "select foo",
+        "select bar",
+        "select \"foo\"",
+        "select \"FOO\"",
+        /*
+         * Strings
+         */
+        "select 'blob'",
+        R"(select "a" || "b")",
+        "select \"a\" COLLATE coll",
+        /*
+         * Row expression
+         */
+        "select * from boo where (ROW (1,2,3)) = ((1,2,3))", // todo: check standard conformance
+        "select (1,2,3),4 from boo",
+        /*
+         * Multiple select targets
+         */
+        "select 1, 2, 3",
+        "select 1, 2 as bar, 3 AS foo",
+        /*
+         * Nested select in target list
+         */
+        "select 1, (select 2), 3",
+        "(select 1)",
+        "((select 1))",
+        /*
+         * Select asterisk
+         */
+        "select 1, * from bar",
+        /*
+         * Set Operations
+         */
+        "select 1 UNION select 2",
+        "select 1 UNION ALL select 2",
+        "select 1 UNION DISTINCT select 2",
+        "select 1 INTERSECT select 2",
+        "select 1 INTERSECT ALL select 2",
+        "select 1 INTERSECT DISTINCT select 2",
+        "select 1 EXCEPT select 2",
+        "select 1 EXCEPT ALL select 2",
+        "select 1 EXCEPT DISTINCT select 2",
+        /*
+         * Joins
+         */
+        "select foo from bar CROSS JOIN boo",
+        "select foo from bar CROSS JOIN (boo JOIN baz ON 1)",
+        "select foo from bar join bar on 1 = 1",
+        "select foo from bar join bar using (foo, faz)",
+        "select foo from bar INNER JOIN bar using (foo, bar)",
+        "select foo from bar FULL JOIN bar ON 1 = 1",
+        "select foo from bar LEFT JOIN bar ON 1 = 1",
+        "select foo from bar RIGHT JOIN bar ON 1 = 1",
+        "select foo from bar RIGHT OUTER JOIN bar ON 1 = 1",
+        "select foo from bar NATURAL LEFT JOIN bar",
+        "select foo from bar NATURAL JOIN bar",
+        /*
+         * multiple base tables
+         */
+        "select foo from bar, boo, boo NATURAL JOIN boo",
+        /*
+         * nested select in from_clause
+         */
+        "select foo from bar, (select 1, 2, 3), baz",
+        /*
+         * Values
+         */
+        "VALUES (1,2,3)",
+        /*
+         * Explicit table ref
+         */
+        "TABLE foo.bar",
+        /*
+         * Table Alias
+         */
+        "select foo from (bar NATURAL JOIN bar) as baz",
+        "select foo from bar b",
+        "select foo from bar b(c,d)",
+        "select foo from bar AS b(c)",
+        "select foo from bar, (select 1, 2, 3) AS boo, baz",
+        /*
+         * Where clause
+         */
+        "select 1 where 2",
+        "select foo from bar where baz = boo",
+        "select foo from bar where baz <> boo",
+        "select foo from bar where baz >= boo",
+        "select foo from bar where baz > boo",
+        "select foo from bar where baz <= boo",
+        "select foo from bar where baz < boo",
+        /*
+         * Group By
+         */
+        "select * from bar GROUP BY ()",
+        "select * from bar GROUP BY (bar, foo COLLATE collation)",
+        "select * from bar GROUP BY ALL bar",
+        "select * from bar GROUP BY DISTINCT bar",
+        "select * from bar GROUP BY bar, baz",
+        "select * from bar GROUP BY ROLLUP (bar, baz)",
+        "select * from bar GROUP BY Cube (bar, (bar, baz))",
+        "select * from bar GROUP BY Cube (bar, baz, foo)",
+        "select * from bar GROUP BY GROUPING SETS (bar, ROLLUP (baz))",
+        /*
+         * Having
+         */
+        "select 1 from bar, baz group by foo HAVING 1 <> 2",
+        /*
+         * Window
+         */
+        "select foo from bar WINDOW windowname AS (existingname)",
+        "select foo from bar WINDOW windowname AS (existingname), windownametwo AS (existingnametwo)",
+        "select foo from bar WINDOW windowname AS (existingname PARTITION BY column)",
+        "select foo from bar WINDOW windowname AS (existingname ORDER BY somecol)",
+        "select foo from bar WINDOW windowname AS (ROWS BETWEEN UNBOUNDED PRECEDING AND UNBOUNDED FOLLOWING EXCLUDE TIES)",
+        "select foo from bar WINDOW windowname AS (ROWS 1 PRECEDING EXCLUDE GROUP)",
+        "select foo from bar WINDOW windowname AS (ROWS CURRENT ROW EXCLUDE CURRENT ROW)",
+        "select foo from bar WINDOW windowname AS (RANGE BETWEEN UNBOUNDED FOLLOWING AND UNBOUNDED FOLLOWING EXCLUDE NO OTHERS)",
+        "select foo from bar WINDOW windowname AS (GROUPS BETWEEN 1 PRECEDING AND 1 FOLLOWING)",
+        /*
+         * CTE
+         */
+        "with foo as (select 1) select * from foo",
+        "with recursive foo as (select 1) select * from foo",
+        "with foo(a,b,c) as (select 1,2,3) select * from foo",
+        /*
+         * Order
+         */
+        "select foo ORDER BY a, 2*b",
+        "select foo ORDER BY foo ASC",
+        "select foo ORDER BY foo DESC",
+        "select foo ORDER BY foo DESC NULLS FIRST",
+        "select foo ORDER BY foo DESC NULLS LAST",
+        /*
+         * Offset
+         */
+        "select foo OFFSET 1 ROW",
+        /*
+         * Fetch
+         */
+        "select foo OFFSET 1 ROW FETCH FIRST ROW WITH TIES",
+        "select foo FETCH FIRST 3 ROWS ONLY",
+        "select foo FETCH FIRST ROW WITH TIES",
+        "select foo FETCH NEXT 1 ROW WITH TIES",
+        "select foo FETCH NEXT 10 PERCENT ROWS ONLY",
+        /*
+         * Exists predicate
+         */
+        "select foo from bar where exists (select 1)",
+        /*
+         * Unique predicate on a subquery
+         */
+        "select foo from bar where unique (select 1)",
+        /*
+         * More predicates
+         */
+        "select foo from bar where baz BETWEEN 1 AND 2",
+        "select foo from bar where baz NOT BETWEEN SYMMETRIC 1 AND 2",
+        "select foo from bar where baz BETWEEN ASYMMETRIC 1 AND 2",
+
+        "select foo from bar where 1 IN (select 1)",
+        "select foo from bar where 1 NOT IN (1,2,3)",
+
+        "select foo from bar where baz LIKE \"woohoo%\"",
+        R"(select foo from bar where baz NOT LIKE "hello world" ESCAPE "a")",
+
+        /*
+         * Boolean logic
+         */
+        "select foo from bar where a AND b",
+        "select foo from bar where a OR b",
+        "select foo from bar where a IS TRUE",
+        "select foo from bar where a IS NOT FALSE",
+        "select foo from bar where a IS UNKNOWN",
+        "select foo from bar where NOT (a OR b)",
+
+        /*
+         * Aggregations
+         */
+        "select count(*) from bar",
+        "select count(*) filter (where false)",
+        "select sum(distinct foo) from bar",
+        "select avg(foo) from bar",
+        "select max(foo) from bar",
+        "select min(foo) from bar",
+        "select every(foo) from bar",
+        "select any(foo) from bar",
+        "select some(foo) from bar",
+        "select count(foo) from bar",
+        "select count(all foo) from bar",
+        "select stddev_pop(foo) from bar",
+        "select stddev_samp(foo) from bar",
+        "select var_pop(foo) from bar",
+        "select var_samp(foo) from bar",
+        "select collect(foo) from bar",
+        "select fusion(foo) from bar",
+        "select intersection(foo) from bar"
+    };
+}
+
 TEST_CASE( "supported concepts", "[cov]") {
     psql_parse::driver driver;
     auto parser = std::bind_front(mustParse, std::ref(driver));
 
-    const char * concepts[] = {
-            /*
-             * Numbers & Arithmetic
-             */
-            "select 1",
-            "select 1.0",
-            "select -1",
-            "select +1",
-            "select 2 * 3, 2+3, 2-3, 2/3",
-            /*
-             * Boolean Literals
-             */
-            "select TRUE,FALSE,UNKNOWN from whatever",
-            /*
-             * Identifiers;
-             */
-            "select foo",
-            "select bar",
-            "select \"foo\"",
-            "select \"FOO\"",
-            /*
-             * Strings
-             */
-            "select 'blob'",
-            R"(select "a" || "b")",
-            "select \"a\" COLLATE coll",
-            /*
-             * Row expression
-             */
-            "select * from boo where (ROW (1,2,3)) = ((1,2,3))", // todo: check standard conformance
-            "select (1,2,3),4 from boo",
-            /*
-             * Multiple select targets
-             */
-            "select 1, 2, 3",
+    for (auto const &c : concepts) {
+        parser(c);
+    }
+
+}
+
+TEST_CASE( "interned identifiers", "[symbol]" ) {
+    using psql_parse::Symbol;
+    psql_parse::driver driver;
+
+    Symbol foo = "foo";
+    REQUIRE(foo == Symbol(std::string("foo")));
+    REQUIRE(foo.hash() == std::hash<std::string_view>{}("foo"));
+    REQUIRE(foo != Symbol("bar"));
+    REQUIRE(Symbol("bar") < foo);
+    REQUIRE(Symbol().empty());
+    REQUIRE(Symbol("") == Symbol());
+
+    auto result = mustParseInto<SelectStatement>(driver, "select FOO from bar");
+    auto &select = std::get<box<SelectExpr>>(result->rel_expr->expr);
+    auto &var = std::get<box<psql_parse::Var>>(select->target_list[0]);
+    REQUIRE(var->name == foo);
+    REQUIRE(var->name.str() == "foo");
+}
+
+TEST_CASE( "arena allocated trees", "[arena]" ) {
+    psql_parse::driver heap;
+    psql_parse::driver arena;
+    arena.useArena(true);
+
+    const char * queries[] = {
             "select 1, 2 as bar, 3 AS foo",
-            /*
-             * Nested select in target list
-             */
-            "select 1, (select 2), 3",
-            "(select 1)",
-            "((select 1))",
-            /*
-             * Select asterisk
-             */
-            "select 1, * from bar",
-            /*
-             * Set Operations
-             */
-            "select 1 UNION select 2",
-            "select 1 UNION ALL select 2",
-            "select 1 UNION DISTINCT select 2",
-            "select 1 INTERSECT select 2",
-            "select 1 INTERSECT ALL select 2",
-            "select 1 INTERSECT DISTINCT select 2",
-            "select 1 EXCEPT select 2",
-            "select 1 EXCEPT ALL select 2",
-            "select 1 EXCEPT DISTINCT select 2",
-            /*
-             * Joins
-             */
-            "select foo from bar CROSS JOIN boo",
-            "select foo from bar CROSS JOIN (boo JOIN baz ON 1)",
-            "select foo from bar join bar on 1 = 1",
-            "select foo from bar join bar using (foo, faz)",
-            "select foo from bar INNER JOIN bar using (foo, bar)",
-            "select foo from bar FULL JOIN bar ON 1 = 1",
-            "select foo from bar LEFT JOIN bar ON 1 = 1",
-            "select foo from bar RIGHT JOIN bar ON 1 = 1",
-            "select foo from bar RIGHT OUTER JOIN bar ON 1 = 1",
-            "select foo from bar NATURAL LEFT JOIN bar",
-            "select foo from bar NATURAL JOIN bar",
-            /*
-             * multiple base tables
-             */
-            "select foo from bar, boo, boo NATURAL JOIN boo",
-            /*
-             * nested select in from_clause
-             */
-            "select foo from bar, (select 1, 2, 3), baz",
-            /*
-             * Values
-             */
-            "VALUES (1,2,3)",
-            /*
-             * Explicit table ref
-             */
-            "TABLE foo.bar",
-            /*
-             * Table Alias
-             */
-            "select foo from (bar NATURAL JOIN bar) as baz",
-            "select foo from bar b",
-            "select foo from bar b(c,d)",
-            "select foo from bar AS b(c)",
-            "select foo from bar, (select 1, 2, 3) AS boo, baz",
-            /*
-             * Where clause
-             */
-            "select 1 where 2",
-            "select foo from bar where baz = boo",
-            "select foo from bar where baz <> boo",
-            "select foo from bar where baz >= boo",
-            "select foo from bar where baz > boo",
-            "select foo from bar where baz <= boo",
-            "select foo from bar where baz < boo",
-            /*
-             * Group By
-             */
-            "select * from bar GROUP BY ()",
-            "select * from bar GROUP BY (bar, foo COLLATE collation)",
-            "select * from bar GROUP BY ALL bar",
-            "select * from bar GROUP BY DISTINCT bar",
-            "select * from bar GROUP BY bar, baz",
-            "select * from bar GROUP BY ROLLUP (bar, baz)",
-            "select * from bar GROUP BY Cube (bar, (bar, baz))",
-            "select * from bar GROUP BY Cube (bar, baz, foo)",
-            "select * from bar GROUP BY GROUPING SETS (bar, ROLLUP (baz))",
-            /*
-             * Having
-             */
-            "select 1 from bar, baz group by foo HAVING 1 <> 2",
-            /*
-             * Window
-             */
-            "select foo from bar WINDOW windowname AS (existingname)",
-            "select foo from bar WINDOW windowname AS (existingname), windownametwo AS (existingnametwo)",
-            "select foo from bar WINDOW windowname AS (existingname PARTITION BY column)",
-            "select foo from bar WINDOW windowname AS (existingname ORDER BY somecol)",
-            "select foo from bar WINDOW windowname AS (ROWS BETWEEN UNBOUNDED PRECEDING AND UNBOUNDED FOLLOWING EXCLUDE TIES)",
-            "select foo from bar WINDOW windowname AS (ROWS 1 PRECEDING EXCLUDE GROUP)",
-            "select foo from bar WINDOW windowname AS (ROWS CURRENT ROW EXCLUDE CURRENT ROW)",
-            "select foo from bar WINDOW windowname AS (RANGE BETWEEN UNBOUNDED FOLLOWING AND UNBOUNDED FOLLOWING EXCLUDE NO OTHERS)",
-            "select foo from bar WINDOW windowname AS (GROUPS BETWEEN 1 PRECEDING AND 1 FOLLOWING)",
-            /*
-             * CTE
-             */
-            "with foo as (select 1) select * from foo",
-            "with recursive foo as (select 1) select * from foo",
-            "with foo(a,b,c) as (select 1,2,3) select * from foo",
-            /*
-             * Order
-             */
-            "select foo ORDER BY a, 2*b",
-            "select foo ORDER BY foo ASC",
-            "select foo ORDER BY foo DESC",
-            "select foo ORDER BY foo DESC NULLS FIRST",
-            "select foo ORDER BY foo DESC NULLS LAST",
-            /*
-             * Offset
-             */
-            "select foo OFFSET 1 ROW",
-            /*
-             * Fetch
-             */
-            "select foo OFFSET 1 ROW FETCH FIRST ROW WITH TIES",
-            "select foo FETCH FIRST 3 ROWS ONLY",
-            "select foo FETCH FIRST ROW WITH TIES",
-            "select foo FETCH NEXT 1 ROW WITH TIES",
-            "select foo FETCH NEXT 10 PERCENT ROWS ONLY",
-            /*
-             * Exists predicate
-             */
-            "select foo from bar where exists (select 1)",
-            /*
-             * Unique predicate on a subquery
-             */
-            "select foo from bar where unique (select 1)",
-            /*
-             * More predicates
-             */
-            "select foo from bar where baz BETWEEN 1 AND 2",
             "select foo from bar where baz NOT BETWEEN SYMMETRIC 1 AND 2",
-            "select foo from bar where baz BETWEEN ASYMMETRIC 1 AND 2",
-
-            "select foo from bar where 1 IN (select 1)",
-            "select foo from bar where 1 NOT IN (1,2,3)",
-
-            "select foo from bar where baz LIKE \"woohoo%\"",
-            R"(select foo from bar where baz NOT LIKE "hello world" ESCAPE "a")",
-
-            /*
-             * Boolean logic
-             */
-            "select foo from bar where a AND b",
-            "select foo from bar where a OR b",
-            "select foo from bar where a IS TRUE",
-            "select foo from bar where a IS NOT FALSE",
-            "select foo from bar where a IS UNKNOWN",
-            "select foo from bar where NOT (a OR b)",
-
-            /*
-             * Aggregations
-             */
-            "select count(*) from bar",
-            "select count(*) filter (where false)",
-            "select sum(distinct foo) from bar",
-            "select avg(foo) from bar",
-            "select max(foo) from bar",
-            "select min(foo) from bar",
-            "select every(foo) from bar",
-            "select any(foo) from bar",
-            "select some(foo) from bar",
-            "select count(foo) from bar",
-            "select count(all foo) from bar",
-            "select stddev_pop(foo) from bar",
-            "select stddev_samp(foo) from bar",
-            "select var_pop(foo) from bar",
-            "select var_samp(foo) from bar",
-            "select collect(foo) from bar",
-            "select fusion(foo) from bar",
-            "select intersection(foo) from bar"
+            "select foo from bar RIGHT OUTER JOIN bar ON 1 = 1",
+            "with foo(a,b,c) as (select 1,2,3) select * from foo"
     };
 
-    for (auto const &c : concepts) {
-        parser(c);
+    for (auto const &q : queries) {
+        auto expected = mustParseInto<SelectStatement>(heap, q);
+        auto result = mustParseInto<SelectStatement>(arena, q);
+        REQUIRE(result == expected);
     }
+}
+
+TEST_CASE( "parsing from a string_view", "[input]" ) {
+    psql_parse::driver driver;
+
+    // not NUL-terminated: the statement ends in the middle of the buffer
+    std::string buffer = "select foo from bar where baz = 'qux'; garbage";
+    std::string_view input(buffer.data(), buffer.find(';'));
+
+    auto expected = mustParseInto<SelectStatement>(driver, std::string(input));
+    REQUIRE(driver.parse(input));
+    REQUIRE(std::get<box<SelectStatement>>(driver.getResult()) == expected);
 
+    // switching back and forth reuses the scanner
+    REQUIRE_FALSE(driver.parse(std::string_view("select from")));
+    REQUIRE(mustParseInto<SelectStatement>(driver, std::string(input)) == expected);
+    REQUIRE(driver.parse(input));
+}
+
+TEST_CASE( "parsing scripts", "[script]" ) {
+    psql_parse::driver driver;
+    psql_parse::driver single;
+
+    std::string script =
+            "select 1;\n"
+            "insert into foo values (1, 2);;\n"
+            "select foo from bar where baz = 2;\n"
+            "delete from foo\n";
+
+    for (bool arena : { false, true }) {
+        driver.useArena(arena);
+
+        std::vector<std::size_t> kinds;
+        std::vector<box<SelectStatement>> selects;
+        REQUIRE(driver.parseScript(script, [&](Statement &stmt) {
+            kinds.push_back(stmt.index());
+            if (std::holds_alternative<box<SelectStatement>>(stmt) && !arena) {
+                selects.push_back(std::move(std::get<box<SelectStatement>>(stmt)));
+            }
+        }));
+        REQUIRE(kinds == std::vector<std::size_t> { 3, 1, 3, 2 });
+
+        if (!arena) {
+            REQUIRE(selects.size() == 2);
+            REQUIRE(selects[0] == mustParseInto<SelectStatement>(single, "select 1"));
+            REQUIRE(selects[1] == mustParseInto<SelectStatement>(single, "select foo from bar where baz = 2"));
+        }
+    }
+
+    SECTION( "statements before an error are delivered" ) {
+        std::size_t count = 0;
+        REQUIRE_FALSE(driver.parseScript("select 1; select from", [&](Statement &) { count++; }));
+        REQUIRE(count == 1);
+    }
+
+    SECTION( "parse() takes exactly one statement" ) {
+        REQUIRE(driver.parse(std::string_view("select 1;")));
+        REQUIRE_FALSE(driver.parse(std::string_view("select 1; select 2")));
+        REQUIRE_FALSE(driver.parse(std::string_view("")));
+        REQUIRE(driver.parseScript("", [](Statement &) { FAIL(); }));
+    }
+}
+
+TEST_CASE( "recovering from syntax errors", "[script]" ) {
+    psql_parse::driver driver;
+    driver.recoverErrors(true);
+
+    std::string script =
+            "select 1;\n"
+            "select from;\n"
+            "select 2;\n"
+            "select a fromm t; select # 3;\n"
+            "select 4";
+
+    std::size_t count = 0;
+    REQUIRE_FALSE(driver.parseScript(script, [&](Statement &) { count++; }));
+    REQUIRE(count == 3);
+
+    auto &diagnostics = driver.diagnostics();
+    REQUIRE(diagnostics.size() == 3);
+    REQUIRE(diagnostics[0].loc.begin.line == 2);
+    REQUIRE(diagnostics[1].loc.begin.line == 4);
+    REQUIRE(diagnostics[2].message == "invalid character: #");
+
+    // a statement that fails at the end of the input
+    REQUIRE_FALSE(driver.parseScript("select 1; select", [](Statement &) { }));
+    REQUIRE(driver.diagnostics().size() == 1);
+
+    REQUIRE(driver.parseScript("select 1; select 2", [](Statement &) { }));
+    REQUIRE(driver.diagnostics().empty());
+
+    SECTION( "without recovery the first error stops the parse" ) {
+        driver.recoverErrors(false);
+        count = 0;
+        REQUIRE_FALSE(driver.parseScript(script, [&](Statement &) { count++; }));
+        REQUIRE(count == 1);
+        REQUIRE(driver.diagnostics().size() == 1);
+    }
+}
+
+TEST_CASE( "streaming insert rows", "[script]" ) {
+    psql_parse::driver driver;
+
+    const std::size_t rows = 2500;
+    std::string insert = "insert into s.t (a, b) values (";
+    for (std::size_t i = 0; i < rows; i++) {
+        insert += (i == 0 ? "(" : ", (") + std::to_string(i) + ", 'x')";
+    }
+    insert += ")";
+
+    std::vector<std::size_t> batches;
+    std::uint64_t next = 0;
+    driver.streamRows([&](const psql_parse::QualifiedName &table, std::vector<Expression> &batch) {
+        REQUIRE(table.name == "t");
+        batches.push_back(batch.size());
+        for (auto &row : batch) {
+            auto &exprs = std::get<box<psql_parse::RowExpr>>(row)->exprs;
+            REQUIRE(std::get<box<psql_parse::IntegerLiteral>>(exprs[0])->value == next++);
+        }
+    }, 1000);
+
+    for (bool arena : { false, true }) {
+        driver.useArena(arena);
+        batches.clear();
+        next = 0;
+
+        auto stmt = mustParseInto<psql_parse::InsertStatement>(driver, std::string(insert));
+        REQUIRE(batches == std::vector<std::size_t> { 1000, 1000, 500 });
+        auto &query = std::get<box<Query>>(stmt->source);
+        REQUIRE(std::get<box<psql_parse::ValuesExpr>>(query->expr)->rows.empty());
+    }
+
+    SECTION( "only the VALUES of an INSERT streams" ) {
+        batches.clear();
+        driver.streamRows([&](const psql_parse::QualifiedName &, std::vector<Expression> &batch) {
+            batches.push_back(batch.size());
+        });
+        REQUIRE(driver.parseScript(
+                "values (1, 2);"
+                "insert into t select * from (values (1, 2)) v;"
+                "insert into t values (1, 2);"
+                "values (3)", [](Statement &) { }));
+        REQUIRE(batches == std::vector<std::size_t> { 2 });
+    }
+
+    SECTION( "a streamed VALUES has to be the whole source" ) {
+        REQUIRE_FALSE(driver.parse(std::string_view("insert into t values (1) union values (2)")));
+        REQUIRE_FALSE(driver.parse(std::string_view("insert into t values (1) order by 1")));
+        driver.streamRows(nullptr);
+        REQUIRE(driver.parse(std::string_view("insert into t values (1) order by 1")));
+    }
+}
+
+TEST_CASE( "incremental reparsing", "[document]" ) {
+    std::string text =
+            "select a from t; select b from u;\n"
+            "select c from v";
+    psql_parse::Document document(text);
+    REQUIRE(document.size() == 3);
+    REQUIRE(document.reparsed() == 3);
+
+    // edit the text and the document, which then has to agree with a fresh parse
+    auto edit = [&](std::size_t offset, std::size_t removed, const std::string &inserted) {
+        text.replace(offset, removed, inserted);
+        document.edit(offset, removed, inserted, text);
+
+        psql_parse::Document fresh(text);
+        REQUIRE(document.size() == fresh.size());
+        for (std::size_t i = 0; i < fresh.size(); i++) {
+            REQUIRE(document.start(i).offset == fresh.start(i).offset);
+            REQUIRE(document.start(i).line == fresh.start(i).line);
+            REQUIRE(document.start(i).column == fresh.start(i).column);
+            REQUIRE(document.diagnostics(i).size() == fresh.diagnostics(i).size());
+            REQUIRE((document.statement(i) == nullptr) == (fresh.statement(i) == nullptr));
+            if (fresh.statement(i) != nullptr) {
+                REQUIRE(*document.statement(i) == *fresh.statement(i));
+                auto loc = document.locate(i, psql_parse::locationOf(*document.statement(i)));
+                auto expected = fresh.locate(i, psql_parse::locationOf(*fresh.statement(i)));
+                REQUIRE(loc.begin.line == expected.begin.line);
+                REQUIRE(loc.begin.column == expected.begin.column);
+                REQUIRE(loc.end.line == expected.end.line);
+                REQUIRE(loc.end.column == expected.end.column);
+            }
+        }
+    };
+    auto node = [&](std::size_t i) {
+        return &*std::get<box<SelectStatement>>(*document.statement(i));
+    };
+
+    auto last = node(2);
+    edit(text.find("a from"), 1, "aaa");
+    REQUIRE(document.reparsed() == 1);
+    REQUIRE(node(2) == last);
+    // the statement after the edit moved along its line
+    auto second = document.locate(1, psql_parse::locationOf(*document.statement(1)));
+    REQUIRE(second.end.line == 1);
+    REQUIRE(second.end.column == static_cast<int>(text.find(" from u") + 7) + 1);
+
+    // without the ';' the first two statements are one syntax error
+    auto semicolon = text.find(';');
+    edit(semicolon, 1, "");
+    REQUIRE(document.size() == 2);
+    REQUIRE(document.reparsed() == 1);
+    REQUIRE(document.statement(0) == nullptr);
+    REQUIRE(document.diagnostics(0).size() == 1);
+    REQUIRE(node(1) == last);
+
+    edit(semicolon, 0, ";");
+    REQUIRE(document.size() == 3);
+    REQUIRE(document.reparsed() == 2);
+    REQUIRE(document.segmentAt(semicolon) == 0);
+    REQUIRE(document.segmentAt(semicolon + 1) == 1);
+
+    // a ';' in a string literal is not a boundary
+    edit(text.find("b from"), 1, "'x;y'");
+    REQUIRE(document.size() == 3);
+    REQUIRE(document.reparsed() == 1);
+
+    // typing at the end only parses the last statement again
+    edit(text.size(), 0, ";\nselect d");
+    REQUIRE(document.size() == 4);
+    REQUIRE(document.reparsed() == 2);
+    REQUIRE(document.locate(3, psql_parse::locationOf(*document.statement(3))).begin.line == 3);
+
+    // an edit across statements
+    auto from = text.find("from u");
+    edit(from, text.find("from v") + 6 - from, "from w");
+    REQUIRE(document.size() == 3);
+    REQUIRE(document.diagnostics(1).empty());
+}
+
+TEST_CASE( "parse sessions", "[session]" ) {
+    psql_parse::ParseSession session;
+    psql_parse::driver heap;
+
+    const char *queries[] = {
+            "select id, name, balance from accounts where id = $1 and status = 'open'",
+            "insert into accounts (id, name, balance) values ($1, $2, 0)",
+            "delete from sessions where id = $1",
+            "select foo from bar RIGHT OUTER JOIN baz ON foo = baz order by foo desc"
+    };
+
+    for (int round = 0; round < 2; round++) {
+        for (auto const &q : queries) {
+            auto result = session.parse(q);
+            REQUIRE(result != nullptr);
+            REQUIRE(*result == mustParse(heap, q));
+        }
+    }
+
+    SECTION( "a warm session does not allocate" ) {
+        auto reserved = session.bytesReserved();
+        auto before = allocations.load();
+        std::size_t parsed = 0;
+        for (auto const &q : queries) {
+            parsed += session.parse(q) != nullptr;
+        }
+        auto after = allocations.load();
+
+        REQUIRE(parsed == std::size(queries));
+        REQUIRE(after == before);
+        REQUIRE(session.bytesReserved() == reserved);
+    }
+
+    SECTION( "memory above the high-water mark is given back" ) {
+        psql_parse::ParseSession small(64 * 1024);
+        std::string wide = "select a";
+        for (int i = 0; i < 20000; i++) {
+            wide += ", a";
+        }
+        REQUIRE(small.parse(wide) != nullptr);
+        REQUIRE(small.bytesReserved() > 64 * 1024);
+
+        REQUIRE(small.parse(queries[0]) != nullptr);
+        REQUIRE(small.bytesReserved() <= 64 * 1024);
+    }
+
+    SECTION( "errors are collected" ) {
+        REQUIRE(session.parse("select from") == nullptr);
+        REQUIRE(session.diagnostics().size() == 1);
+        REQUIRE(session.parse(queries[0]) != nullptr);
+    }
+}
+
+TEST_CASE( "parse statistics", "[stats]" ) {
+    psql_parse::driver driver;
+    psql_parse::StatsCollector collector;
+    driver.collectStats(&collector);
+    driver.useArena(true);
+
+    mustParse(driver, "select a, b from t where a = 1");
+    auto &stats = driver.stats();
+
+    if constexpr (!psql_parse::ParseStats::enabled) {
+        REQUIRE(stats.tokens == 0);
+        REQUIRE(collector.snapshot().parses == 0);
+        return;
+    }
+
+    // select a , b from t where a = 1 and the end of input
+    REQUIRE(stats.tokens == 11);
+    REQUIRE(stats.nodes[psql_parse::nodeIndex<psql_parse::Var>] == 3);
+    REQUIRE(stats.nodes[psql_parse::nodeIndex<psql_parse::BinaryOp>] == 1);
+    REQUIRE(stats.nodes[psql_parse::nodeIndex<psql_parse::SelectStatement>] == 1);
+    REQUIRE(stats.node_bytes > 0);
+    REQUIRE(stats.arena_bytes >= stats.node_bytes);
+    REQUIRE(stats.max_stack_depth > 0);
+    REQUIRE(stats.scan_ns <= stats.total_ns);
+    REQUIRE(std::string(psql_parse::nodeTypeName(psql_parse::nodeIndex<psql_parse::Var>)) == "Var");
+
+    REQUIRE(driver.parseScript("select 1; select 2", [](Statement &) { }));
+    REQUIRE(driver.stats().nodes[psql_parse::nodeIndex<psql_parse::IntegerLiteral>] == 2);
+
+    auto snapshot = collector.take();
+    REQUIRE(snapshot.parses == 2);
+    REQUIRE(snapshot.totals.tokens == 11 + 6);
+    REQUIRE(collector.snapshot().parses == 0);
+}
+
+TEST_CASE( "parsing in parallel", "[batch]" ) {
+    psql_parse::driver driver;
+
+    std::vector<std::string> owned;
+    for (int i = 0; i < 200; i++) {
+        owned.push_back(i % 7 == 3
+                ? "select from"
+                : "select a" + std::to_string(i % 10) + " from b where c = " + std::to_string(i));
+    }
+    std::vector<std::string_view> queries(owned.begin(), owned.end());
+
+    for (unsigned threads : { 1u, 3u, 8u }) {
+        auto results = psql_parse::parseBatch(queries, threads);
+        REQUIRE(results.size() == queries.size());
+
+        for (std::size_t i = 0; i < queries.size(); i++) {
+            if (i % 7 == 3) {
+                REQUIRE_FALSE(results[i].has_value());
+            } else {
+                REQUIRE(results[i].has_value());
+                auto expected = mustParseInto<SelectStatement>(driver, std::string(queries[i]));
+                REQUIRE(std::get<box<SelectStatement>>(*results[i]) == expected);
+            }
+        }
+    }
+
+    REQUIRE(psql_parse::parseBatch({}).empty());
+}
+
+TEST_CASE( "parse cache", "[cache]" ) {
+    psql_parse::driver driver;
+    psql_parse::ParseCache cache(2, 1);
+
+    auto first = cache.get("select a from t");
+    REQUIRE(first != nullptr);
+    REQUIRE(std::get<box<SelectStatement>>(*first) == mustParseInto<SelectStatement>(driver, "select a from t"));
+    REQUIRE(cache.get("select a from t") == first);
+    REQUIRE(cache.get("select from") == nullptr);
+
+    auto second = cache.get("select b from t");
+    cache.get("select a from t");
+    cache.get("select c from t");
+
+    auto stats = cache.stats();
+    REQUIRE(stats.hits == 2);
+    REQUIRE(stats.misses == 4);
+    REQUIRE(stats.evictions == 1);
+    REQUIRE(stats.size == 2);
+
+    // the least recently used entry was evicted, the caller still owns its tree
+    REQUIRE(cache.get("select a from t") == first);
+    REQUIRE(cache.get("select b from t") != second);
+    REQUIRE(std::get<box<SelectStatement>>(*second) == mustParseInto<SelectStatement>(driver, "select b from t"));
+
+    cache.clear();
+    REQUIRE(cache.stats().size == 0);
+    REQUIRE(cache.get("select a from t") != first);
+}
+
+TEST_CASE( "node locations", "[loc]" ) {
+    psql_parse::driver driver;
+
+    auto heapResult = mustParseInto<SelectStatement>(driver, "select a,\n  42 from t");
+    auto &select = std::get<box<SelectExpr>>(heapResult->rel_expr->expr);
+    auto &loc = psql_parse::locationOf(select->target_list[1]);
+    REQUIRE(loc.end.line == 2);
+    REQUIRE(loc.end.column == 5);
+
+    driver.useArena(true);
+    auto arenaResult = mustParseInto<SelectStatement>(driver, "select a,\n  42 from t");
+    auto &arenaSelect = std::get<box<SelectExpr>>(arenaResult->rel_expr->expr);
+    auto &arenaLoc = psql_parse::locationOf(arenaSelect->target_list[1]);
+    REQUIRE(arenaLoc.end.line == loc.end.line);
+    REQUIRE(arenaLoc.end.column == loc.end.column);
+    REQUIRE(psql_parse::locationOf(arenaResult->rel_expr->expr).end.column == select->loc.end.column);
+}
+
+TEST_CASE( "query fingerprints", "[fingerprint]" ) {
+    psql_parse::driver driver;
+    auto fingerprint = [&](std::string sql) {
+        auto stmt = mustParse(driver, std::move(sql));
+        return psql_parse::fingerprint(stmt);
+    };
+
+    auto base = fingerprint("select a, b from t where a = 1 and b like 'x%' order by 2 fetch first 10 rows only");
+
+    SECTION( "literal values are ignored" ) {
+        REQUIRE(fingerprint("SELECT a, b FROM t WHERE a = 42 AND b LIKE 'y' ORDER BY 7 FETCH FIRST 3 ROWS ONLY") == base);
+        REQUIRE(fingerprint("select a from t where a = true") == fingerprint("select a from t where a = false"));
+        REQUIRE(fingerprint("insert into t values (1, 'a')") == fingerprint("insert into t values (2, 'b')"));
+    }
+
+    SECTION( "structure, operators and identifiers are not" ) {
+        REQUIRE(fingerprint("select a, c from t where a = 1 and b like 'x%' order by 2 fetch first 10 rows only") != base);
+        REQUIRE(fingerprint("select a, b from u where a = 1 and b like 'x%' order by 2 fetch first 10 rows only") != base);
+        REQUIRE(fingerprint("select a, b from t where a < 1 and b like 'x%' order by 2 fetch first 10 rows only") != base);
+        REQUIRE(fingerprint("select a, b from t where a = 1 or b like 'x%' order by 2 fetch first 10 rows only") != base);
+        REQUIRE(fingerprint("select a, b from t where a = 1 and b like 'x%' order by 2 desc fetch first 10 rows only") != base);
+        REQUIRE(fingerprint("select a, b from t where a = 1 and b like 'x%' order by 2") != base);
+        REQUIRE(fingerprint("select a from t where a = 1") != fingerprint("select a from t where a = 1.5"));
+        REQUIRE(fingerprint("select a from t where a is true") != fingerprint("select a from t where a is false"));
+        REQUIRE(fingerprint("select a from t, u") != fingerprint("select a, t from u"));
+        REQUIRE(fingerprint("select 1 + (2 + 3)") != fingerprint("select (1 + 2) + 3"));
+        REQUIRE(fingerprint("select count(a) from t") != fingerprint("select sum(a) from t"));
+        REQUIRE(fingerprint("select a from t as x") != fingerprint("select a from t as y"));
+        REQUIRE(fingerprint("select a from t group by a") != fingerprint("select a from t group by b"));
+        REQUIRE(fingerprint("select a from t offset 1 rows") != fingerprint("select a from t"));
+    }
+}
+
+TEST_CASE( "parameterizing literals", "[param]" ) {
+    psql_parse::driver driver;
+    using psql_parse::IntegerLiteral;
+    using psql_parse::FloatLiteral;
+    using psql_parse::StringLiteral;
+    using psql_parse::BooleanLiteral;
+
+    SECTION( "literals become $n in order" ) {
+        auto result = psql_parse::parameterize(mustParse(driver, "insert into t values (1, 'a', true, 2.5)"));
+        REQUIRE(result.existing == 0);
+        REQUIRE(result.constants.size() == 4);
+        REQUIRE(std::get<box<IntegerLiteral>>(result.constants[0])->value == 1);
+        REQUIRE(std::get<box<StringLiteral>>(result.constants[1])->value == "a");
+        REQUIRE(std::get<box<BooleanLiteral>>(result.constants[2])->value == BooleanLiteral::Val::TRUE);
+        REQUIRE(std::get<box<FloatLiteral>>(result.constants[3])->value == 2.5);
+        REQUIRE(std::get<box<StringLiteral>>(result.constants[1])->loc.begin.column > 22);
+        REQUIRE(result.statement == mustParse(driver, "insert into t values ($1, $2, $3, $4)"));
+    }
+
+    SECTION( "existing parameters and syntax literals are kept" ) {
+        auto result = psql_parse::parameterize(mustParse(driver,
+                "select a, 'x' from t where b = 1 and c between 2.5 and $1 and d is true order by 3 offset 4 rows"));
+        REQUIRE(result.existing == 1);
+        REQUIRE(result.constants.size() == 4);
+        REQUIRE(result.statement == mustParse(driver,
+                "select a, $2 from t where b = $3 and c between $4 and $1 and d is true order by $5 offset 4 rows"));
+    }
+
+    SECTION( "queries differing in literals normalize to the same tree" ) {
+        // a driver's arena only holds one result at a time
+        psql_parse::driver other;
+        driver.useArena(true);
+        other.useArena(true);
+        psql_parse::Arena arena;
+        auto left = psql_parse::parameterize(mustParse(driver, "select a from t where b = 1 and c like 'x%'"), &arena);
+        auto right = psql_parse::parameterize(mustParse(other, "select a from t where b = 7 and c like 'y'"), &arena);
+        REQUIRE(left.statement == right.statement);
+        REQUIRE(left.constants != right.constants);
+    }
+}
+
+TEST_CASE( "token streams", "[tokens]" ) {
+    using kind = psql_parse::parser::symbol_kind;
+
+    std::string sql =
+            "SELECT a, \"Mixed Case\", 'it''s', b'101', X'ff', n'x', 1, 2.5, .5, 3., $1 FROM t\n"
+            "  WHERE a <> b AND c <= d OR e >= f || g < h AND i > -j * k / l + m.n;\n"
+            "select x_1 from [y] where (z) = 1";
+
+    // the kinds the parser's scanner reads
+    std::vector<psql_parse::parser::symbol_kind_type> expected;
+    psql_parse::scanner scanner;
+    scanner.reset(std::string_view(sql));
+    for (;;) {
+        auto token = scanner.lex();
+        if (token.kind() == kind::S_YYEOF) {
+            break;
+        }
+        expected.push_back(token.kind());
+    }
+
+    auto tokens = psql_parse::tokenize(sql);
+    REQUIRE(tokens.size() == expected.size());
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        REQUIRE(tokens[i].kind == expected[i]);
+    }
+
+    REQUIRE(tokens[0].kind == kind::S_SELECT);
+    REQUIRE(tokens[0].text(sql) == "SELECT");
+    REQUIRE(tokens[3].text(sql) == "\"Mixed Case\"");
+    REQUIRE(tokens[5].text(sql) == "'it''s'");
+    REQUIRE(tokens[7].kind == kind::S_BIT_VALUE);
+    REQUIRE(tokens[7].text(sql) == "b'101'");
+    REQUIRE(tokens.back().offset + tokens.back().length == sql.size());
+
+    // appended to what is there
+    psql_parse::tokenize("a # 'open", tokens);
+    REQUIRE(tokens.size() == expected.size() + 3);
+    REQUIRE(tokens[tokens.size() - 2].kind == kind::S_YYUNDEF);
+    REQUIRE(tokens.back().kind == kind::S_YYUNDEF);
+    REQUIRE(tokens.back().offset == 4);
+    REQUIRE(tokens.back().length == 5);
+
+    REQUIRE(psql_parse::tokenize("").empty());
+    REQUIRE(psql_parse::tokenize(" \t\n ").empty());
+}
+
+TEST_CASE( "vector scanning kernels", "[simd]" ) {
+    using psql_parse::simd::blankRun;
+    using psql_parse::simd::findQuote;
+
+    SECTION( "every length and position, including the tails" ) {
+        for (std::size_t size = 0; size <= 100; size++) {
+            for (std::size_t at = 0; at <= size; at++) {
+                std::string text(size, 'x');
+                std::fill_n(text.begin(), at, " \t\r\f"[at % 4]);
+                REQUIRE(blankRun(text) == at);
+
+                text.assign(size, 'x');
+                if (at < size) {
+                    text[at] = '\'';
+                    if (at + 1 < size) {
+                        text[at + 1] = '\'';
+                    }
+                }
+                REQUIRE(findQuote(text, '\'') == at);
+                REQUIRE(findQuote(text, '"') == size);
+            }
+        }
+        REQUIRE(blankRun(" \n ") == 1);
+    }
+
+    SECTION( "long literals and blank runs" ) {
+        psql_parse::driver driver;
+        std::string text;
+        while (text.size() < 5000) {
+            text += "it's \"quoted\" text ";
+        }
+        std::string quoted;
+        for (char c : text) {
+            quoted += c;
+            if (c == '\'') {
+                quoted += c;
+            }
+        }
+        auto result = psql_parse::parameterize(mustParse(driver,
+                "insert into t values (\t\t\t\t                                       '" + quoted + "',"
+                + std::string(300, ' ') + "'')"));
+        REQUIRE(result.constants.size() == 2);
+        REQUIRE(std::get<box<psql_parse::StringLiteral>>(result.constants[0])->value == text);
+        REQUIRE(std::get<box<psql_parse::StringLiteral>>(result.constants[1])->value.empty());
+    }
+}
+
+TEST_CASE( "flat trees", "[flat]" ) {
+    psql_parse::driver driver;
+    using psql_parse::FlatTree;
+    using psql_parse::Flat;
+    using psql_parse::field;
+
+    SECTION( "expanding gives back the tree that was flattened" ) {
+        const char* statements[] = {
+            "select a, 2 * b as c, 'x', 1.5, true, $1 from t where a is not true",
+            "select distinct count(*) filter (where a > 1), sum(all b) from t group by rollup (a, b), cube (c) having 1 <> 2",
+            "select a from t as u(b, c) natural left join v join w using (x, y) where a between symmetric 1 and 2",
+            "select a from t where a in (select b from u) and exists (select 1) or unique (select 2) and b not like 'x' escape 'y'",
+            "select (1, 2, 3), -a, not b, c collate d.e from t where (select 1) = 1",
+            "with recursive r (n) as (select 1 union all select n from r) select * from r order by n desc nulls first "
+                "offset 2 rows fetch next 10 percent rows with ties",
+            "select a from t window w as (v partition by a order by b rows between 1 preceding and current row exclude ties)",
+            "values (1, 2)",
+            "table s.t",
+            "insert into t (a, b) values (1, 'x')",
+            "insert into t default values",
+            "delete from only (t) where a = 1",
+        };
+
+        for (auto sql : statements) {
+            INFO(sql);
+            auto stmt = mustParse(driver, sql);
+            FlatTree flat(stmt);
+            FlatTree copy = flat;
+            flat.clear();
+
+            auto expanded = copy.expand();
+            REQUIRE(expanded == stmt);
+            REQUIRE(psql_parse::locationOf(expanded).end.column == psql_parse::locationOf(stmt).end.column);
+
+            psql_parse::Arena arena;
+            REQUIRE(copy.expand(&arena) == stmt);
+        }
+    }
+
+    SECTION( "create table" ) {
+        auto stmt = mustParse(driver,
+                "create local temporary table s.t (a integer default 1 not null, b varchar 10 collate c, "
+                "c row (x real, y decimal(10, 2)) array, d ref (u) scope v, "
+                "e blob references u (a) match full on delete cascade, primary key (a), "
+                "foreign key (b) references u (b)) on commit preserve rows");
+        FlatTree flat(stmt);
+        auto& original = std::get<box<psql_parse::CreateStatement>>(stmt);
+        auto expanded = std::get<box<psql_parse::CreateStatement>>(flat.expand());
+
+        REQUIRE(expanded->rel_name == original->rel_name);
+        REQUIRE(expanded->column_defs.size() == 5);
+        REQUIRE(expanded->column_defs == original->column_defs);
+        REQUIRE(expanded->table_constraints == original->table_constraints);
+        REQUIRE(expanded->temp == psql_parse::Temporary::LOCAL);
+        REQUIRE(expanded->on_commit == psql_parse::OnCommit::PRESERVE);
+    }
+
+    SECTION( "walking the flat form" ) {
+        FlatTree flat(mustParse(driver, "select a + 1, b from t where c = a"));
+
+        struct Counter {
+            int vars = 0;
+            int ops = 0;
+
+            void enter(const Flat<psql_parse::Var>&) { vars++; }
+
+            bool enter(const Flat<psql_parse::BinaryOp>& op) {
+                ops++;
+                return field<0>(op) != psql_parse::BinaryOp::Op::EQUAL;
+            }
+        } counter;
+        flat.walk(counter);
+        REQUIRE(counter.ops == 2);
+        REQUIRE(counter.vars == 2);
+
+        // every node of a type, in pre-order
+        auto vars = flat.nodes<psql_parse::Var>();
+        REQUIRE(vars.size() == 4);
+        REQUIRE(flat[field<0>(vars[0])] == "a");
+        REQUIRE(flat[field<0>(vars[3])] == "a");
+        REQUIRE(vars[2].loc.begin_column < vars[3].loc.begin_column);
+    }
+
+    SECTION( "binary blobs" ) {
+        const char* statements[] = {
+            "select a, b from t where a = 'x' and b > $1",
+            "with w as (select 1) select * from w order by 1 fetch first 5 rows only",
+            "create table t (a integer not null, b char 3)",
+        };
+
+        std::string blobs;
+        for (auto sql : statements) {
+            FlatTree(mustParse(driver, sql)).write(blobs);
+        }
+        REQUIRE(blobs.size() % 8 == 0);
+
+        // read in place, one blob after the other
+        std::string_view bytes = blobs;
+        for (auto sql : statements) {
+            INFO(sql);
+            auto view = psql_parse::FlatView::read(bytes);
+            REQUIRE(view.has_value());
+            auto stmt = mustParse(driver, sql);
+            REQUIRE(view->size() == FlatTree(stmt).size());
+            auto expanded = view->expand();
+            REQUIRE(expanded == stmt);
+            REQUIRE(psql_parse::locationOf(expanded).end.column == psql_parse::locationOf(stmt).end.column);
+        }
+        REQUIRE(bytes.empty());
+        REQUIRE_FALSE(psql_parse::FlatView::read(bytes).has_value());
+
+        std::string blob;
+        FlatTree(mustParse(driver, statements[0])).write(blob);
+
+        std::string_view truncated(blob.data(), blob.size() - 8);
+        REQUIRE_FALSE(psql_parse::FlatView::read(truncated).has_value());
+
+        std::string bad_magic = blob;
+        bad_magic[0] = 'X';
+        std::string_view magic_bytes = bad_magic;
+        REQUIRE_FALSE(psql_parse::FlatView::read(magic_bytes).has_value());
+
+        // a Var whose name points past the end of the text
+        FlatTree flat(mustParse(driver, statements[0]));
+        auto var = flat.nodes<psql_parse::Var>()[0];
+        auto corrupt = blob;
+        auto at = corrupt.find(std::string_view(reinterpret_cast<const char*>(&var), sizeof(var)));
+        REQUIRE(at != std::string::npos);
+        field<0>(var).offset = 1 << 20;
+        corrupt.replace(at, sizeof(var), reinterpret_cast<const char*>(&var), sizeof(var));
+        std::string_view corrupt_bytes = corrupt;
+        REQUIRE_FALSE(psql_parse::FlatView::read(corrupt_bytes).has_value());
+        REQUIRE(corrupt_bytes.size() == corrupt.size());
+    }
+}
+
+TEST_CASE( "deparsing", "[deparse]" ) {
+    psql_parse::driver driver;
+
+    // printing is also a fixpoint, which covers CREATE TABLE, whose == ignores its members
+    auto roundTrip = [&](const std::string& sql) {
+        INFO(sql);
+        auto stmt = mustParse(driver, std::string(sql));
+        auto text = psql_parse::deparse(stmt);
+        INFO(text);
+        auto again = mustParse(driver, std::string(text));
+        REQUIRE(again == stmt);
+        REQUIRE(psql_parse::deparse(again) == text);
+    };
+
+    SECTION( "every supported construct" ) {
+        for (auto sql : concepts) {
+            roundTrip(sql);
+        }
+    }
+
+    SECTION( "create table" ) {
+        const char* statements[] = {
+            "create table t (a integer)",
+            "create local temporary table s.t (a integer default 1 not null unique, b varchar 10 octets collate c, "
+                "c row (x real, y decimal(10, 2)) array[3], d ref (u) scope v, e nchar varying 5 multiset, "
+                "f blob(100) constraint k references u (a, b) match full on delete cascade on update set null, "
+                "primary key (a, b), unique (c), foreign key (b, a) references u (b, a) match partial)",
+            "create global temporary table t (a timestamp(3) with time zone default current_user, "
+                "b time without time zone default null, c date default -1.5, d double precision default 'x''y', "
+                "e numeric(5) default true, f float(7), g smallint, h bigint, i boolean, j character, "
+                "k character 4 characters, l clob 100, m nclob, n binary(2), o varbinary(8), p s.type) "
+                "on commit preserve rows",
+        };
+
+        for (auto sql : statements) {
+            roundTrip(sql);
+
+            auto stmt = mustParse(driver, sql);
+            auto again = mustParse(driver, psql_parse::deparse(stmt));
+            auto& original = std::get<box<psql_parse::CreateStatement>>(stmt);
+            auto& reparsed = std::get<box<psql_parse::CreateStatement>>(again);
+            REQUIRE(reparsed->rel_name == original->rel_name);
+            REQUIRE(reparsed->temp == original->temp);
+            REQUIRE(reparsed->on_commit == original->on_commit);
+            REQUIRE(reparsed->column_defs == original->column_defs);
+            REQUIRE(reparsed->table_constraints == original->table_constraints);
+        }
+
+        // lists keep the order they were written in
+        auto stmt = mustParse(driver, "create table t (a integer, b integer not null unique, primary key (b, a))");
+        auto& create = std::get<box<psql_parse::CreateStatement>>(stmt);
+        REQUIRE(create->column_defs[0].name == psql_parse::Name("a"));
+        REQUIRE(std::get<psql_parse::ConstraintType>(create->column_defs[1].col_constraint[0].constraint)
+                == psql_parse::ConstraintType::NOT_NULL);
+        REQUIRE(std::get<psql_parse::TablePrimaryKeyConstraint>(create->table_constraints[0]).column_names
+                == psql_parse::List<psql_parse::Name> { "b", "a" });
+    }
+
+    SECTION( "literals and names" ) {
+        const char* statements[] = {
+            "select 'it''s', b'0101', x'ff', n'x''y', '', 0.1, 123.0, .5, 18446744073709551615",
+            R"(select "Select", "a b", "from", "FOO", x1, "", _y from "Order" as "T" ("K"))",
+            R"(insert into "Order" ("key", b) values (1, 2))",
+            "insert into t select a from u union all select b from v",
+            "delete from only (s.t) where a in (1, 2, 3)",
+            "delete from t",
+            "select * from (select 1) as t (a) where $3 > -1 and - a < +b",
+            "select (select 1 order by 1) union (select 2) except table t order by 1 offset 2 rows",
+            "select a from t join (u cross join v) on a = b natural right join w",
+        };
+
+        for (auto sql : statements) {
+            roundTrip(sql);
+        }
+        REQUIRE(psql_parse::deparse(mustParse(driver, "select \"a b\" as x from t where a like 'x%'"))
+                == "SELECT \"a b\" AS x FROM t WHERE (a LIKE 'x%')");
+    }
+
+    SECTION( "random expressions" ) {
+        std::mt19937 random(42);
+        auto pick = [&](int n) { return std::uniform_int_distribution<int>(0, n - 1)(random); };
+
+        // precedence is left to the parser: operators are written without parentheses where the grammar allows it
+        std::function<std::string(int)> expr = [&](int depth) -> std::string {
+            if (depth == 0) {
+                const char* atoms[] = { "a", "\"B c\"", "1", "2.5", "'x''y'", "true", "$1", "(select 1)", "count(*)" };
+                return atoms[pick(std::size(atoms))];
+            }
+            auto left = expr(depth - 1);
+            auto right = expr(depth - 1);
+            switch (pick(14)) {
+                case 0: return left + " + " + right;
+                case 1: return left + " - " + right;
+                case 2: return left + " * " + right;
+                case 3: return left + " / " + right;
+                case 4: return left + " || " + right;
+                case 5: return "- " + left;
+                case 6: return left + " collate c";
+                case 7: return "(" + left + " = " + right + ")";
+                case 8: return "(" + left + " and " + right + " or " + left + ")";
+                case 9: return "(not " + left + ")";
+                case 10: return "(" + left + " between " + right + " and " + left + ")";
+                case 11: return "(" + left + " not like " + right + ")";
+                case 12: return "(" + left + " in (" + right + ", 1))";
+                default: return "sum(distinct " + left + ") filter (where " + right + ")";
+            }
+        };
+
+        for (int i = 0; i < 200; i++) {
+            roundTrip("select " + expr(3) + ", " + expr(2) + " as x from t where " + expr(2));
+        }
+    }
+
+    SECTION( "appending to a buffer" ) {
+        auto stmt = mustParse(driver, "select 1");
+        std::string out = "x; ";
+        psql_parse::deparse(stmt, out);
+        REQUIRE(out == "x; SELECT 1");
+    }
 }
 
 TEST_CASE( "visit tests" ) {
@@ -398,3 +1324,47 @@ TEST_CASE( "visit tests" ) {
     p.print(expr2);
 }
 
+namespace {
+    // nesting depth of the BinaryOps on the way to the current node
+    struct DepthCounter {
+        std::size_t depth = 0;
+        std::size_t deepest = 0;
+        std::size_t vars = 0;
+
+        void enter(box<psql_parse::BinaryOp>&) { deepest = std::max(deepest, ++depth); }
+        void leave(box<psql_parse::BinaryOp>&) { depth--; }
+        void enter(box<psql_parse::Var>&) { vars++; }
+    };
+}
+
+TEST_CASE( "deep trees", "[visit]" ) {
+    psql_parse::driver driver;
+
+    // a long OR chain is a left deep BinaryOp tree, one level per term
+    const int terms = 20000;
+    std::string sql = "select a";
+    for (int i = 1; i < terms; i++) {
+        sql += " or a";
+    }
+    auto stmt = mustParse(driver, std::move(sql));
+
+    SECTION( "pre- and post-order hooks" ) {
+        DepthCounter counter;
+        psql_parse::default_visit<DepthCounter> walker { counter };
+        walker.visit(stmt);
+        REQUIRE(counter.deepest == terms - 1);
+        REQUIRE(counter.depth == 0);
+        REQUIRE(counter.vars == terms);
+    }
+
+    SECTION( "fingerprint and deparse" ) {
+        REQUIRE(psql_parse::fingerprint(stmt) != 0);
+
+        std::string expected = "SELECT " + std::string(terms - 1, '(') + "a";
+        for (int i = 1; i < terms; i++) {
+            expected += " OR a)";
+        }
+        REQUIRE(psql_parse::deparse(stmt) == expected);
+    }
+}
+